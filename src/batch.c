@@ -0,0 +1,225 @@
+#include <string.h>
+#include "batch.h"
+#include "tables.h"
+
+#define ALL_DIGITS 0x3FE   // Bits 1..9 set
+
+// Candidate masks in structure-of-arrays form: cand[cell][lane].
+// Every loop over lanes has a fixed trip count and no branches, so the
+// compiler turns it into SIMD instructions working on all puzzles at once.
+typedef unsigned short lane_masks[BATCH_LANES];
+
+// Remove the value of every solved cell from its peers (naked singles)
+static void eliminate_naked_singles(lane_masks cand[NUM_CELLS]) {
+    for (int cell = 0; cell < NUM_CELLS; cell++) {
+        lane_masks keep;
+        for (int l = 0; l < BATCH_LANES; l++) {
+            unsigned short m = cand[cell][l];
+            // A single bit means the cell is solved: clear that bit in the peers
+            keep[l] = (m & (m - 1)) ? 0xFFFF : (unsigned short)~m;
+        }
+        for (int p = 0; p < NUM_PEERS; p++) {
+            unsigned short *peer = cand[peer_cells[cell][p]];
+            for (int l = 0; l < BATCH_LANES; l++) {
+                peer[l] &= keep[l];
+            }
+        }
+    }
+}
+
+// Place digits that fit in only one cell of a unit (hidden singles)
+static void place_hidden_singles(lane_masks cand[NUM_CELLS]) {
+    for (int u = 0; u < NUM_UNITS; u++) {
+        lane_masks once, twice;
+        memset(once, 0, sizeof(once));
+        memset(twice, 0, sizeof(twice));
+
+        for (int i = 0; i < SIZE; i++) {
+            const unsigned short *m = cand[unit_cells[u][i]];
+            for (int l = 0; l < BATCH_LANES; l++) {
+                twice[l] |= once[l] & m[l];
+                once[l] |= m[l];
+            }
+        }
+
+        for (int i = 0; i < SIZE; i++) {
+            unsigned short *m = cand[unit_cells[u][i]];
+            for (int l = 0; l < BATCH_LANES; l++) {
+                unsigned short hidden = m[l] & once[l] & (unsigned short)~twice[l];
+                m[l] = hidden ? hidden : m[l];
+            }
+        }
+    }
+}
+
+// Run singles propagation on one batch of up to BATCH_LANES puzzles
+static void propagate_lanes(int grids[][SIZE][SIZE], int status[], int count) {
+    lane_masks cand[NUM_CELLS];
+
+    // Load puzzles into lanes; unused lanes stay fully open and never change
+    for (int cell = 0; cell < NUM_CELLS; cell++) {
+        for (int l = 0; l < BATCH_LANES; l++) {
+            int value = l < count ? grids[l][cell / SIZE][cell % SIZE] : 0;
+            cand[cell][l] = (value >= 1 && value <= SIZE) ? (unsigned short)(1u << value) : ALL_DIGITS;
+        }
+    }
+
+    // Repeat until no lane changes any more
+    for (;;) {
+        lane_masks before[NUM_CELLS];
+        memcpy(before, cand, sizeof(before));
+
+        eliminate_naked_singles(cand);
+        place_hidden_singles(cand);
+
+        unsigned short changed = 0;
+        for (int cell = 0; cell < NUM_CELLS; cell++) {
+            for (int l = 0; l < BATCH_LANES; l++) {
+                changed |= cand[cell][l] ^ before[cell][l];
+            }
+        }
+        if (!changed) break;
+    }
+
+    // Read back each lane: store solved cells and classify the puzzle
+    for (int l = 0; l < count; l++) {
+        int solved = 1, broken = 0;
+
+        for (int cell = 0; cell < NUM_CELLS && !broken; cell++) {
+            unsigned short m = cand[cell][l];
+            if (m == 0) {
+                broken = 1; // No digit left for this cell
+            } else if (m & (m - 1)) {
+                solved = 0;
+                grids[l][cell / SIZE][cell % SIZE] = 0;
+            } else {
+                int value = 0;
+                while (!(m & (1u << value))) value++;
+                grids[l][cell / SIZE][cell % SIZE] = value;
+            }
+        }
+
+        // A unit that lost every candidate for some digit can't be completed
+        for (int u = 0; u < NUM_UNITS && !broken; u++) {
+            unsigned short all = 0;
+            for (int i = 0; i < SIZE; i++) {
+                all |= cand[unit_cells[u][i]][l];
+            }
+            if (all != ALL_DIGITS) broken = 1;
+        }
+
+        status[l] = broken ? BATCH_CONTRADICTION : (solved ? BATCH_SOLVED : BATCH_STUCK);
+    }
+}
+
+// Fill every naked and hidden single in count puzzles
+void batch_propagate(int grids[][SIZE][SIZE], int status[], int count) {
+    for (int start = 0; start < count; start += BATCH_LANES) {
+        int lanes = count - start < BATCH_LANES ? count - start : BATCH_LANES;
+        propagate_lanes(grids + start, status + start, lanes);
+    }
+}
+
+// Solve count puzzles in place, backtracking only where propagation got stuck
+int solve_sudoku_batch(int grids[][SIZE][SIZE], int solved[], int count) {
+    int total = 0;
+
+    batch_propagate(grids, solved, count);
+
+    for (int i = 0; i < count; i++) {
+        if (solved[i] == BATCH_STUCK) {
+            // Propagation only removed impossible digits, so the backtracker
+            // can carry on from the partly filled grid
+            solved[i] = solve_sudoku(grids[i]);
+        } else {
+            solved[i] = (solved[i] == BATCH_SOLVED);
+        }
+        total += solved[i];
+    }
+    return total;
+}
+
+// Digit bit of cell k of the packed grid g: low_cell_bit / high_cell_bit map
+// each byte straight to its two cells. k is always a constant below, so the
+// nibble choice and the byte offset fold away.
+#define CELL_BIT(g, k) ((k) & 1 ? high_cell_bit[(g)[(k) / 2]] : low_cell_bit[(g)[(k) / 2]])
+
+// OR row r's nine cells into the column masks and the current band's box
+// masks, and fail the grid unless the row itself holds exactly 1-9
+#define VERIFY_ROW(g, r) do { \
+    unsigned c0 = CELL_BIT(g, (r) * 9 + 0), c1 = CELL_BIT(g, (r) * 9 + 1), c2 = CELL_BIT(g, (r) * 9 + 2); \
+    unsigned c3 = CELL_BIT(g, (r) * 9 + 3), c4 = CELL_BIT(g, (r) * 9 + 4), c5 = CELL_BIT(g, (r) * 9 + 5); \
+    unsigned c6 = CELL_BIT(g, (r) * 9 + 6), c7 = CELL_BIT(g, (r) * 9 + 7), c8 = CELL_BIT(g, (r) * 9 + 8); \
+    unsigned left = c0 | c1 | c2, middle = c3 | c4 | c5, right = c6 | c7 | c8; \
+    bad |= (left | middle | right) ^ ALL_DIGITS; \
+    box0 |= left; box1 |= middle; box2 |= right; \
+    col0 |= c0; col1 |= c1; col2 |= c2; col3 |= c3; col4 |= c4; \
+    col5 |= c5; col6 |= c6; col7 |= c7; col8 |= c8; \
+} while (0)
+
+// Three rows make a band, which completes three boxes
+#define VERIFY_BAND(g, b) do { \
+    unsigned box0 = 0, box1 = 0, box2 = 0; \
+    VERIFY_ROW(g, 3 * (b)); VERIFY_ROW(g, 3 * (b) + 1); VERIFY_ROW(g, 3 * (b) + 2); \
+    bad |= (box0 ^ ALL_DIGITS) | (box1 ^ ALL_DIGITS) | (box2 ^ ALL_DIGITS); \
+} while (0)
+
+// Nonzero unless every row, column and box of the packed grid holds exactly
+// 1-9. Fully unrolled so all 27 masks stay in registers.
+static unsigned packed_grid_errors(const unsigned char *g) {
+    unsigned col0 = 0, col1 = 0, col2 = 0, col3 = 0, col4 = 0;
+    unsigned col5 = 0, col6 = 0, col7 = 0, col8 = 0;
+    unsigned bad = 0;
+
+    VERIFY_BAND(g, 0);
+    VERIFY_BAND(g, 1);
+    VERIFY_BAND(g, 2);
+    bad |= (col0 ^ ALL_DIGITS) | (col1 ^ ALL_DIGITS) | (col2 ^ ALL_DIGITS) |
+           (col3 ^ ALL_DIGITS) | (col4 ^ ALL_DIGITS) | (col5 ^ ALL_DIGITS) |
+           (col6 ^ ALL_DIGITS) | (col7 ^ ALL_DIGITS) | (col8 ^ ALL_DIGITS);
+    return bad;
+}
+
+// Every unit mask of one packed grid, for reporting which unit failed
+static void unit_masks(const unsigned char *grid, unsigned short units[NUM_UNITS]) {
+    memset(units, 0, NUM_UNITS * sizeof(units[0]));
+    for (int row = 0; row < SIZE; row++) {
+        for (int col = 0; col < SIZE; col++) {
+            int cell = row * SIZE + col;
+            unsigned char byte = grid[cell / 2];
+            unsigned short bit = (cell & 1) ? high_cell_bit[byte] : low_cell_bit[byte];
+            units[row] |= bit;
+            units[SIZE + col] |= bit;
+            units[2 * SIZE + box_of_cell[cell]] |= bit;
+        }
+    }
+}
+
+// Check packed completed grids straight from their bytes. A unit passes when
+// the digit bits of its nine cells add up to exactly 1-9; an empty cell
+// (bit 0), an out-of-range value (bits 10-15) or a repeat breaks that.
+int verify_packed_grids(const unsigned char *packed, int count,
+                        unsigned char pass_bits[], int first_bad_unit[]) {
+    int passed = 0;
+
+    memset(pass_bits, 0, (size_t)(count + 7) / 8);
+
+    for (int index = 0; index < count; index++) {
+        const unsigned char *grid = packed + (size_t)index * SUDOKU_PACKED_SIZE;
+
+        if (!packed_grid_errors(grid)) {
+            pass_bits[index / 8] |= (unsigned char)(1u << (index % 8));
+            passed++;
+            if (first_bad_unit) first_bad_unit[index] = -1;
+        } else if (first_bad_unit) {
+            // Only failing grids pay for finding the offending unit
+            unsigned short units[NUM_UNITS];
+            int u = 0;
+
+            unit_masks(grid, units);
+            while (units[u] == ALL_DIGITS) u++;
+            first_bad_unit[index] = u;
+        }
+    }
+    return passed;
+}
@@ -0,0 +1,34 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "sudoku.h"
+#include "enumerate.h"
+
+// Number of puzzles propagated side by side. 16 lanes of 16-bit candidate
+// masks fill one 256-bit AVX2 register (two SSE2 registers).
+#define BATCH_LANES 16
+
+// Per-puzzle status reported by batch_propagate
+#define BATCH_CONTRADICTION 0   // Puzzle has no solution
+#define BATCH_SOLVED        1   // Singles alone filled the whole grid
+#define BATCH_STUCK         2   // Singles stalled; the grid needs guessing
+
+// Fill every naked and hidden single in count puzzles, BATCH_LANES at a time.
+// Grids are updated in place and status[i] is set for each one.
+void batch_propagate(int grids[][SIZE][SIZE], int status[], int count);
+
+// Solve count puzzles in place. Propagation runs on all lanes in lockstep and
+// only puzzles that get stuck are handed to the backtracking solver.
+// solved[i] is set to 1 if grid i was solved; returns the number solved.
+int solve_sudoku_batch(int grids[][SIZE][SIZE], int solved[], int count);
+
+// Check count completed grids stored back to back in packed form
+// (SUDOKU_PACKED_SIZE bytes each, see pack_grid). Bit i of pass_bits
+// ((count + 7) / 8 bytes) is set if grid i is a valid solution. If
+// first_bad_unit is not NULL it receives, per grid, the first failing
+// unit (rows 0-8, columns 9-17, boxes 18-26) or -1 for passing grids.
+// Returns the number of grids that passed.
+int verify_packed_grids(const unsigned char *packed, int count,
+                        unsigned char pass_bits[], int first_bad_unit[]);
+
+#endif
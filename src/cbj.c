@@ -0,0 +1,315 @@
+#include <stdint.h>
+#include <string.h>
+#include "cbj.h"
+#include "tables.h"
+#include "trace.h"
+
+#define MAX_LEVEL (NUM_CELLS + 1)   // Level 0 holds the clues, levels 1..81 the decisions
+#define NO_LEVEL (-1)
+
+// Set of decision levels (bit n = level n)
+typedef struct {
+    uint64_t w[2];
+} level_set;
+
+#define LIT_STRIDE (SIZE + 1)
+#define NUM_LITS (NUM_CELLS * LIT_STRIDE) // Literal = cell * LIT_STRIDE + digit
+#define NOGOOD_WORDS (NOGOOD_CAPACITY / 64)
+
+// One learned nogood: a set of (cell, digit) decisions that can't all hold
+typedef struct {
+    unsigned short lit[NOGOOD_MAX_LITS];
+    unsigned short len;
+} nogood;
+
+// Complete search state
+typedef struct {
+    unsigned short domain[NUM_CELLS];          // Remaining candidate digits (bits 1..9)
+    signed char elim[NUM_CELLS][SIZE + 1];     // Level that removed each digit, NO_LEVEL if still present
+    signed char cell_level[NUM_CELLS];         // Level a cell was assigned at, NO_LEVEL if unassigned
+    unsigned char value[NUM_CELLS];            // Digit assigned to each cell
+
+    unsigned char level_cell[MAX_LEVEL];       // Cell decided at each level
+    unsigned short remaining[MAX_LEVEL];       // Digits still to try at each level
+    level_set conflict[MAX_LEVEL];             // Earlier levels blamed for failures at each level
+    int trail_start[MAX_LEVEL];                // First trail entry made by each level
+
+    unsigned short trail[NUM_CELLS * SIZE];    // Eliminations (literals) in order made
+    int trail_len;
+
+    nogood nogoods[NOGOOD_CAPACITY];           // Ring buffer of learned nogoods
+    uint64_t lit_nogoods[NUM_LITS][NOGOOD_WORDS]; // Bit i set if nogood i contains the literal
+    int nogood_next;
+
+    cbj_stats stats;
+} cbj_state;
+
+static void set_add(level_set *s, int level) {
+    s->w[level >> 6] |= (uint64_t)1 << (level & 63);
+}
+
+static void set_remove(level_set *s, int level) {
+    s->w[level >> 6] &= ~((uint64_t)1 << (level & 63));
+}
+
+static void set_merge(level_set *dst, const level_set *src) {
+    dst->w[0] |= src->w[0];
+    dst->w[1] |= src->w[1];
+}
+
+// Index of the lowest set bit of a non-zero word
+static int lowest_bit(uint64_t w) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(w);
+#else
+    int bit = 0;
+    while (!((w >> bit) & 1)) bit++;
+    return bit;
+#endif
+}
+
+// Index of the highest set bit of a non-zero word
+static int highest_bit(uint64_t w) {
+#if defined(__GNUC__)
+    return 63 - __builtin_clzll(w);
+#else
+    int bit = 63;
+    while (!(w >> bit)) bit--;
+    return bit;
+#endif
+}
+
+// Highest level in the set, or 0 if the set is empty
+static int set_max(const level_set *s) {
+    if (s->w[1]) return 64 + highest_bit(s->w[1]);
+    if (s->w[0]) return highest_bit(s->w[0]);
+    return 0;
+}
+
+static int lowest_digit(unsigned short mask) {
+    return lowest_bit(mask);
+}
+
+// Add every level that removed a digit from cell's domain to the set
+static void blame_eliminations(cbj_state *s, int cell, level_set *set) {
+    for (int digit = 1; digit <= SIZE; digit++) {
+        if (s->elim[cell][digit] > 0) {
+            set_add(set, s->elim[cell][digit]);
+        }
+    }
+}
+
+// Assign digit to cell at level and remove it from all unassigned peers.
+// Returns the peer whose domain became empty, or -1 if none did.
+static int assign(cbj_state *s, int cell, int digit, int level) {
+    s->cell_level[cell] = (signed char)level;
+    s->value[cell] = (unsigned char)digit;
+    s->trail_start[level] = s->trail_len;
+
+    unsigned short bit = (unsigned short)(1u << digit);
+    for (int p = 0; p < NUM_PEERS; p++) {
+        int peer = peer_cells[cell][p];
+        if (s->cell_level[peer] != NO_LEVEL || !(s->domain[peer] & bit)) continue;
+
+        s->domain[peer] &= (unsigned short)~bit;
+        s->elim[peer][digit] = (signed char)level;
+        s->trail[s->trail_len++] = (unsigned short)(peer * LIT_STRIDE + digit);
+        TRACE_EVENT(TRACE_ELIMINATE, peer, digit, level);
+        if (s->domain[peer] == 0) {
+            return peer;
+        }
+    }
+    return -1;
+}
+
+// Undo the assignment made at level and every elimination it caused
+static void unassign(cbj_state *s, int level) {
+    while (s->trail_len > s->trail_start[level]) {
+        unsigned short entry = s->trail[--s->trail_len];
+        int cell = entry / LIT_STRIDE, digit = entry % LIT_STRIDE;
+        s->domain[cell] |= (unsigned short)(1u << digit);
+        s->elim[cell][digit] = NO_LEVEL;
+    }
+    int cell = s->level_cell[level];
+    s->cell_level[cell] = NO_LEVEL;
+    s->value[cell] = 0;
+}
+
+// Store the decisions at the levels in set as a nogood (if it is small enough)
+static void learn_nogood(cbj_state *s, const level_set *set) {
+    nogood ng;
+    ng.len = 0;
+    for (int level = 1; level < MAX_LEVEL; level++) {
+        if (!(set->w[level >> 6] & ((uint64_t)1 << (level & 63)))) continue;
+        if (ng.len == NOGOOD_MAX_LITS) return;
+        int cell = s->level_cell[level];
+        ng.lit[ng.len++] = (unsigned short)(cell * LIT_STRIDE + s->value[cell]);
+    }
+    if (ng.len == 0) return;
+
+    // Overwrite the oldest slot, dropping it from the literal index first
+    int slot = s->nogood_next;
+    uint64_t slot_bit = (uint64_t)1 << (slot & 63);
+    for (int j = 0; j < s->nogoods[slot].len; j++) {
+        s->lit_nogoods[s->nogoods[slot].lit[j]][slot >> 6] &= ~slot_bit;
+    }
+    s->nogoods[slot] = ng;
+    for (int j = 0; j < ng.len; j++) {
+        s->lit_nogoods[ng.lit[j]][slot >> 6] |= slot_bit;
+    }
+    s->nogood_next = (slot + 1) % NOGOOD_CAPACITY;
+    s->stats.nogoods_learned++;
+}
+
+// Check whether assigning digit to cell would complete a stored nogood.
+// Only nogoods containing that literal are looked at, via the literal index.
+// If one is complete, the levels of its other decisions are added to blame.
+static int violates_nogood(cbj_state *s, int cell, int digit, level_set *blame) {
+    unsigned short target = (unsigned short)(cell * LIT_STRIDE + digit);
+
+    for (int w = 0; w < NOGOOD_WORDS; w++) {
+        for (uint64_t bits = s->lit_nogoods[target][w]; bits; bits &= bits - 1) {
+            int slot = w * 64 + lowest_bit(bits);
+
+            const nogood *ng = &s->nogoods[slot];
+            int others_hold = 1;
+            for (int j = 0; j < ng->len && others_hold; j++) {
+                int lit_cell = ng->lit[j] / LIT_STRIDE, lit_digit = ng->lit[j] % LIT_STRIDE;
+                if (ng->lit[j] != target &&
+                    (s->cell_level[lit_cell] == NO_LEVEL || s->value[lit_cell] != lit_digit)) {
+                    others_hold = 0;
+                }
+            }
+            if (!others_hold) continue;
+
+            for (int j = 0; j < ng->len; j++) {
+                if (ng->lit[j] != target) {
+                    set_add(blame, s->cell_level[ng->lit[j] / LIT_STRIDE]);
+                }
+            }
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Unassigned cell with the fewest candidates, or -1 if every cell is assigned
+static int pick_cell(cbj_state *s) {
+    int best = -1, best_count = SIZE + 1;
+    for (int cell = 0; cell < NUM_CELLS; cell++) {
+        if (s->cell_level[cell] != NO_LEVEL) continue;
+        int count = 0;
+        for (unsigned short m = s->domain[cell]; m; m &= (unsigned short)(m - 1)) count++;
+        if (count < best_count) {
+            best = cell;
+            best_count = count;
+            if (count <= 1) break; // Can't do better than a forced cell
+        }
+    }
+    return best;
+}
+
+// Solve using forward checking with conflict-directed backjumping.
+// Every failure records which earlier decisions caused it; when a cell runs
+// out of digits the search jumps straight back to the latest decision that
+// was blamed, instead of retrying the ones in between.
+int solve_sudoku_cbj(int grid[SIZE][SIZE], cbj_stats *stats) {
+    cbj_state s;
+    int level = 0;
+
+    memset(&s, 0, sizeof(s));
+    memset(s.elim, NO_LEVEL, sizeof(s.elim));
+    memset(s.cell_level, NO_LEVEL, sizeof(s.cell_level));
+    for (int cell = 0; cell < NUM_CELLS; cell++) {
+        s.domain[cell] = 0x3FE;
+    }
+
+    // Level 0: place the clues. Failures here are never backjumped over.
+    for (int cell = 0; cell < NUM_CELLS; cell++) {
+        int digit = grid[cell / SIZE][cell % SIZE];
+        if (digit == 0) continue;
+        if (digit < 1 || digit > SIZE || !(s.domain[cell] & (1u << digit))) {
+            if (stats) *stats = s.stats;
+            return 0; // Invalid or conflicting clue
+        }
+        s.level_cell[0] = (unsigned char)cell;
+        if (assign(&s, cell, digit, 0) >= 0) {
+            if (stats) *stats = s.stats;
+            return 0; // Clues leave some cell without a candidate
+        }
+    }
+    s.trail_len = 0; // Clue eliminations are never undone
+
+    for (;;) {
+        // Choose the next cell to decide
+        int cell = pick_cell(&s);
+        if (cell < 0) {
+            break; // Every cell has a value
+        }
+        level++;
+        s.level_cell[level] = (unsigned char)cell;
+        s.remaining[level] = s.domain[cell];
+        memset(&s.conflict[level], 0, sizeof(level_set));
+        TRACE_EVENT(TRACE_DECISION, cell, 0, level);
+
+        // Try digits at this level, backjumping when it runs out of them
+        for (;;) {
+            int placed = 0;
+            cell = s.level_cell[level];
+
+            while (s.remaining[level]) {
+                int digit = lowest_digit(s.remaining[level]);
+                s.remaining[level] &= (unsigned short)~(1u << digit);
+                s.stats.nodes++;
+
+                if (violates_nogood(&s, cell, digit, &s.conflict[level])) {
+                    s.stats.nogood_hits++;
+                    continue;
+                }
+
+                TRACE_EVENT(TRACE_ASSIGN, cell, digit, level);
+                int wiped = assign(&s, cell, digit, level);
+                if (wiped < 0) {
+                    placed = 1;
+                    break;
+                }
+
+                // The wiped-out peer lost its other digits to earlier levels
+                blame_eliminations(&s, wiped, &s.conflict[level]);
+                set_remove(&s.conflict[level], level);
+                unassign(&s, level);
+            }
+            if (placed) break;
+
+            // Every digit failed: blame the failures plus whatever pruned
+            // this cell's domain before it was chosen
+            level_set culprits = s.conflict[level];
+            blame_eliminations(&s, cell, &culprits);
+            set_remove(&culprits, level);
+
+            int target = set_max(&culprits);
+            if (target == 0) {
+                if (stats) *stats = s.stats;
+                return 0; // Only the clues are to blame: no solution
+            }
+
+            learn_nogood(&s, &culprits);
+            if (target < level - 1) s.stats.backjumps++;
+
+            // Undo every decision above the culprit, then the culprit itself
+            for (int l = level - 1; l >= target; l--) {
+                unassign(&s, l);
+            }
+            set_remove(&culprits, target);
+            set_merge(&s.conflict[target], &culprits);
+            level = target;
+            TRACE_EVENT(TRACE_BACKTRACK, s.level_cell[level], 0, level);
+        }
+    }
+
+    for (int cell = 0; cell < NUM_CELLS; cell++) {
+        grid[cell / SIZE][cell % SIZE] = s.value[cell];
+    }
+    if (stats) *stats = s.stats;
+    return 1;
+}
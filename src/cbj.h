@@ -0,0 +1,26 @@
+#ifndef CBJ_H
+#define CBJ_H
+
+#include "sudoku.h"
+
+// Learned nogoods are kept in a fixed ring of NOGOOD_CAPACITY entries
+// (2 KB), plus a per-literal index of the nogoods that mention it
+// (NUM_CELLS * (SIZE + 1) literals x NOGOOD_CAPACITY bits, about 13 KB).
+// Conflicts involving more than NOGOOD_MAX_LITS decisions are not stored.
+#define NOGOOD_CAPACITY 128
+#define NOGOOD_MAX_LITS 7
+
+// Search counters for comparing against the plain backtracker
+typedef struct {
+    unsigned long long nodes;            // Values assigned to a cell
+    unsigned long long backjumps;        // Backtracks that skipped at least one decision
+    unsigned long long nogoods_learned;  // Nogoods added to the store
+    unsigned long long nogood_hits;      // Values rejected by a stored nogood
+} cbj_stats;
+
+// Solve grid in place using forward checking with conflict-directed
+// backjumping and nogood learning. stats may be NULL.
+// Returns 1 if a solution was found, 0 otherwise.
+int solve_sudoku_cbj(int grid[SIZE][SIZE], cbj_stats *stats);
+
+#endif
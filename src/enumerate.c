@@ -0,0 +1,178 @@
+#include <stdio.h>
+#include <string.h>
+#include "enumerate.h"
+#include "tables.h"
+#include "trace.h"
+
+// Prepare an enumerator for the given puzzle (0 = empty cell).
+// Returns 0 if the clues already break a sudoku rule; the enumerator
+// is then marked done and yields nothing.
+int enum_init(sudoku_enum *e, int grid[SIZE][SIZE]) {
+    memset(e, 0, sizeof(*e));
+
+    for (int row = 0; row < SIZE; row++) {
+        for (int col = 0; col < SIZE; col++) {
+            int num = grid[row][col];
+            e->grid[row][col] = num;
+
+            if (num == 0) {
+                // Empty cells are searched in row-major order, like solve_sudoku
+                e->empty[e->empty_count++] = (unsigned char)(row * SIZE + col);
+                continue;
+            }
+
+            if (num < 1 || num > SIZE) {
+                e->done = 1; // Out-of-range value
+                return 0;
+            }
+
+            unsigned short bit = (unsigned short)(1u << num);
+            int box = box_of_cell[row * SIZE + col];
+            if ((e->row_used[row] & bit) || (e->col_used[col] & bit) || (e->box_used[box] & bit)) {
+                e->done = 1; // Duplicate clue
+                return 0;
+            }
+            e->row_used[row] |= bit;
+            e->col_used[col] |= bit;
+            e->box_used[box] |= bit;
+        }
+    }
+    return 1;
+}
+
+// Advance the search until the next solution is found, the search space is
+// exhausted, or node_budget placements have been tried (0 = no limit).
+// All state lives in the enumerator, so a paused search resumes exactly
+// where it stopped.
+int enum_next_limited(sudoku_enum *e, int solution[SIZE][SIZE], unsigned long long node_budget) {
+    unsigned long long nodes_this_call = 0;
+
+    if (e->done) {
+        return ENUM_DONE;
+    }
+
+    for (;;) {
+        if (e->depth < 0) {
+            // Backtracked past the first empty cell - nothing left to try
+            e->done = 1;
+            return ENUM_DONE;
+        }
+
+        if (e->depth == e->empty_count) {
+            // Every empty cell is filled: report the solution, then step back
+            // so the next call continues with the deepest cell's next number
+            memcpy(solution, e->grid, sizeof(e->grid));
+            e->solutions++;
+            e->depth--;
+            return ENUM_FOUND;
+        }
+
+        if (node_budget && nodes_this_call >= node_budget) {
+            return ENUM_PAUSED;
+        }
+
+        int cell = e->empty[e->depth];
+        int row = cell / SIZE;
+        int col = cell % SIZE;
+        int box = box_of_cell[cell];
+
+        // Remove the number currently placed at this depth (if any)
+        int num = e->grid[row][col];
+        if (num == 0) {
+            TRACE_EVENT(TRACE_DECISION, cell, 0, e->depth); // First visit since the last backtrack
+        } else {
+            unsigned short mask = (unsigned short)~(1u << num);
+            e->row_used[row] &= mask;
+            e->col_used[col] &= mask;
+            e->box_used[box] &= mask;
+            e->grid[row][col] = 0;
+        }
+
+        // Find the next number that fits in this cell
+        unsigned int used = e->row_used[row] | e->col_used[col] | e->box_used[box];
+        num++;
+        while (num <= SIZE && (used & (1u << num))) {
+            num++;
+        }
+
+        if (num > SIZE) {
+            // No number left for this cell, so backtrack
+            TRACE_EVENT(TRACE_BACKTRACK, cell, 0, e->depth);
+            e->depth--;
+            continue;
+        }
+
+        // Place the number and move on to the next empty cell
+        unsigned short bit = (unsigned short)(1u << num);
+        e->row_used[row] |= bit;
+        e->col_used[col] |= bit;
+        e->box_used[box] |= bit;
+        e->grid[row][col] = num;
+        TRACE_EVENT(TRACE_ASSIGN, cell, num, e->depth);
+        e->nodes++;
+        nodes_this_call++;
+        e->depth++;
+    }
+}
+
+// Find the next solution without a node budget
+int enum_next(sudoku_enum *e, int solution[SIZE][SIZE]) {
+    return enum_next_limited(e, solution, 0) == ENUM_FOUND;
+}
+
+// Call callback for every solution of grid, in the same order the iterator
+// yields them. Returns the number of solutions passed to the callback.
+unsigned long long enumerate_solutions(int grid[SIZE][SIZE], enum_callback callback, void *user) {
+    sudoku_enum e;
+    int solution[SIZE][SIZE];
+
+    if (!enum_init(&e, grid)) {
+        return 0;
+    }
+
+    while (enum_next(&e, solution)) {
+        if (!callback(solution, user)) {
+            break; // Caller asked us to stop
+        }
+    }
+    return e.solutions;
+}
+
+// Stream up to max_solutions solutions (0 = all) to out in packed form.
+// Only one solution is held in memory at a time.
+// Returns the number of solutions written.
+unsigned long long enumerate_to_file(int grid[SIZE][SIZE], FILE *out, unsigned long long max_solutions) {
+    sudoku_enum e;
+    int solution[SIZE][SIZE];
+    unsigned char packed[SUDOKU_PACKED_SIZE];
+    unsigned long long written = 0;
+
+    if (!enum_init(&e, grid)) {
+        return 0;
+    }
+
+    while ((max_solutions == 0 || written < max_solutions) && enum_next(&e, solution)) {
+        pack_grid(solution, packed);
+        if (fwrite(packed, sizeof(packed), 1, out) != 1) {
+            break; // Write error - stop streaming
+        }
+        written++;
+    }
+    return written;
+}
+
+// Pack a grid into 4 bits per cell, two cells per byte (first cell in the low nibble)
+void pack_grid(int grid[SIZE][SIZE], unsigned char packed[SUDOKU_PACKED_SIZE]) {
+    memset(packed, 0, SUDOKU_PACKED_SIZE);
+    for (int cell = 0; cell < SIZE * SIZE; cell++) {
+        int value = grid[cell / SIZE][cell % SIZE] & 0x0F;
+        packed[cell / 2] |= (unsigned char)(value << ((cell % 2) * 4));
+    }
+}
+
+// Inverse of pack_grid
+void unpack_grid(const unsigned char packed[SUDOKU_PACKED_SIZE], int grid[SIZE][SIZE]) {
+    for (int cell = 0; cell < SIZE * SIZE; cell++) {
+        grid[cell / SIZE][cell % SIZE] = (packed[cell / 2] >> ((cell % 2) * 4)) & 0x0F;
+    }
+}
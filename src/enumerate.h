@@ -0,0 +1,47 @@
+#ifndef ENUMERATE_H
+#define ENUMERATE_H
+
+#include <stdio.h>
+#include "sudoku.h"
+
+// Size of one solution in packed form (two cells per byte, 4 bits each)
+#define SUDOKU_PACKED_SIZE ((SIZE * SIZE + 1) / 2)
+
+// Return codes for enum_next_limited
+#define ENUM_DONE   0   // Search space exhausted, no more solutions
+#define ENUM_FOUND  1   // A solution was written to the output grid
+#define ENUM_PAUSED 2   // Node budget used up, call again to resume
+
+// Complete search state of the solution enumerator.
+// The struct holds no pointers, so it can be copied or written to disk
+// as a checkpoint and resumed later from the copy.
+typedef struct {
+    int grid[SIZE][SIZE];                // Clues plus the current partial assignment
+    unsigned short row_used[SIZE];       // Bit n set if digit n is used in the row
+    unsigned short col_used[SIZE];       // Bit n set if digit n is used in the column
+    unsigned short box_used[SIZE];       // Bit n set if digit n is used in the 3x3 box
+    unsigned char empty[SIZE * SIZE];    // Empty cells (row * SIZE + col) in search order
+    int empty_count;                     // Number of entries in empty[]
+    int depth;                           // Number of empty cells currently filled
+    int done;                            // Set once the search space is exhausted
+    unsigned long long nodes;            // Placements tried so far
+    unsigned long long solutions;        // Solutions yielded so far
+} sudoku_enum;
+
+// Called for every solution; return 0 to stop the enumeration
+typedef int (*enum_callback)(int solution[SIZE][SIZE], void *user);
+
+// Iterator interface
+int enum_init(sudoku_enum *e, int grid[SIZE][SIZE]);
+int enum_next(sudoku_enum *e, int solution[SIZE][SIZE]);
+int enum_next_limited(sudoku_enum *e, int solution[SIZE][SIZE], unsigned long long node_budget);
+
+// Callback and streaming interface
+unsigned long long enumerate_solutions(int grid[SIZE][SIZE], enum_callback callback, void *user);
+unsigned long long enumerate_to_file(int grid[SIZE][SIZE], FILE *out, unsigned long long max_solutions);
+
+// Packed solution format
+void pack_grid(int grid[SIZE][SIZE], unsigned char packed[SUDOKU_PACKED_SIZE]);
+void unpack_grid(const unsigned char packed[SUDOKU_PACKED_SIZE], int grid[SIZE][SIZE]);
+
+#endif
@@ -1,9 +1,12 @@
 #include <windows.h>
 #include <commctrl.h>
 #include <stdio.h>
+#include <string.h>
 #include <time.h>
 #include "gui.h"
 #include "sudoku.h"
+#include "tables.h"
+#include "jobs.h"
 #pragma comment(lib, "comctl32.lib")
 
 // Global for tracking hints left in game mode
@@ -11,6 +14,23 @@ static int hints_left = MAX_HINTS;
 // Global for storing current puzzle solution in game mode
 static int current_solution[SIZE][SIZE];
 static int has_puzzle = 0;
+// Last solver-tab solve, reused when only a few clues change. Owned by
+// solve_job while one is running.
+static solve_state last_solve = {0};
+// Background jobs started from the buttons
+static sudoku_job *solve_job = NULL;     // Running solve, NULL when idle
+static sudoku_job *generate_job = NULL;  // Running puzzle generation, NULL when idle
+
+// Job callbacks run on a worker thread, so they only post messages to the
+// window and the UI is updated from WindowProc
+static void OnJobProgress(sudoku_job *job, unsigned long long nodes, int depth, void *user) {
+    (void)job;
+    PostMessage((HWND)user, WM_JOB_PROGRESS, (WPARAM)depth, (LPARAM)(nodes / 1000));
+}
+
+static void OnJobDone(sudoku_job *job, void *user) {
+    PostMessage((HWND)user, WM_JOB_DONE, 0, (LPARAM)job);
+}
 
 // Window procedure - handles all messages sent to our window
 LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
@@ -19,6 +39,9 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
             // Initialize common controls
             InitCommonControls();
             
+            // Seed the random numbers used by puzzle generation
+            srand((unsigned int)time(NULL));
+            
             // Create tab control
             hTab = CreateWindowEx(0, WC_TABCONTROLA, "", WS_CHILD | WS_CLIPSIBLINGS | WS_VISIBLE,
                 0, 0, WINDOW_WIDTH, WINDOW_HEIGHT, hwnd, (HMENU)ID_TAB, GetModuleHandle(NULL), NULL);
@@ -53,6 +76,12 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
             // A button was clicked or control was activated
             switch (LOWORD(wParam)) {
                 case ID_SOLVE_BUTTON: {
+                    // While a search is running the button cancels it
+                    if (solve_job) {
+                        job_cancel(solve_job);
+                        break;
+                    }
+                    
                     // Get current grid from GUI
                     int grid[SIZE][SIZE];
                     GetGridFromGUI(hwnd, grid);
@@ -77,17 +106,16 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
                         MessageBox(hwnd, "The grid has duplicate numbers in a row, column, or box. Please fix your input.", "Invalid Sudoku Input", MB_OK | MB_ICONERROR);
                         break;
                     }
-                    // Try to solve the sudoku
-                    if (solve_sudoku(grid)) {
-                        // Solution found - display it in the GUI
-                        SetGridToGUI(hwnd, grid);
-                        MessageBox(hwnd, "Sudoku solved successfully!", "Success", 
-                                  MB_OK | MB_ICONINFORMATION);
-                    } else {
-                        // No solution exists
-                        MessageBox(hwnd, "No solution exists for this puzzle!\nPlease check your input.", 
-                                  "Error", MB_OK | MB_ICONERROR);
+                    // Solve in the background, starting from the previous
+                    // solution when only a few clues have changed;
+                    // WM_JOB_DONE shows the result
+                    job_callbacks callbacks = {OnJobProgress, OnJobDone, hwnd};
+                    solve_job = job_submit_resolve(&last_solve, grid, &callbacks);
+                    if (!solve_job) {
+                        MessageBox(hwnd, "Could not start the solver.", "Error", MB_OK | MB_ICONERROR);
+                        break;
                     }
+                    SetDlgItemText(hwnd, ID_SOLVE_BUTTON, "Cancel");
                     break;
                 }                case ID_CLEAR_BUTTON:
                     // Clear all cells in the grid
@@ -97,13 +125,18 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
                     // Load an example Sudoku puzzle
                     LoadExamplePuzzle(hwnd);
                     break;                case ID_GENERATE: {
-                    // Generate a new puzzle
-                    static int puzzle[SIZE][SIZE];
-                    GenerateSudokuPuzzle(puzzle, current_solution);
-                    SetGridToGUI(hwnd, puzzle);
-                    hints_left = MAX_HINTS; // Reset hints
-                    has_puzzle = 1; // Mark that we have a puzzle with known solution
-                    MessageBox(hwnd, "New puzzle generated! Try to solve it.", "New Puzzle", MB_OK | MB_ICONINFORMATION);
+                    // Generate a new puzzle in the background (medium difficulty = 1)
+                    if (generate_job) {
+                        break; // Already generating one
+                    }
+                    job_callbacks callbacks = {NULL, OnJobDone, hwnd};
+                    generate_job = job_submit_generate(1, &callbacks);
+                    if (!generate_job) {
+                        // No worker threads: generate right here instead
+                        static int puzzle[SIZE][SIZE];
+                        GenerateSudokuPuzzle(puzzle, current_solution);
+                        ShowNewPuzzle(hwnd, puzzle);
+                    }
                     break;
                 }                case ID_CHECK: {
                     // Check if current solution is correct
@@ -182,8 +215,59 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
             }
             break;
             
+        case WM_JOB_PROGRESS: {
+            // Show how far the running solve has got in the title bar
+            char title[128];
+            sprintf(title, "%s - solving: %lu thousand nodes, depth %d",
+                    WINDOW_TITLE, (unsigned long)lParam, (int)wParam);
+            SetWindowText(hwnd, title);
+            break;
+        }
+        case WM_JOB_DONE: {
+            // A background job finished (or was cancelled)
+            sudoku_job *job = (sudoku_job *)lParam;
+            job_result result;
+            job_get_result(job, &result);
+            
+            if (job == solve_job) {
+                solve_job = NULL;
+                SetWindowText(hwnd, WINDOW_TITLE);
+                SetDlgItemText(hwnd, ID_SOLVE_BUTTON, "Solve Puzzle");
+                if (result.state == JOB_CANCELLED) {
+                    MessageBox(hwnd, "Solving was cancelled.", "Cancelled", MB_OK | MB_ICONINFORMATION);
+                } else if (result.solved) {
+                    // Solution found - display it in the GUI
+                    SetGridToGUI(hwnd, result.solution);
+                    MessageBox(hwnd, "Sudoku solved successfully!", "Success", 
+                              MB_OK | MB_ICONINFORMATION);
+                } else {
+                    // No solution exists
+                    MessageBox(hwnd, "No solution exists for this puzzle!\nPlease check your input.", 
+                              "Error", MB_OK | MB_ICONERROR);
+                }
+            } else if (job == generate_job) {
+                generate_job = NULL;
+                if (result.state == JOB_FINISHED && result.solved) {
+                    memcpy(current_solution, result.solution, sizeof(current_solution));
+                    ShowNewPuzzle(hwnd, result.puzzle);
+                } else {
+                    // Generation failed - try again here, falling back to the example puzzle
+                    static int puzzle[SIZE][SIZE];
+                    GenerateSudokuPuzzle(puzzle, current_solution);
+                    ShowNewPuzzle(hwnd, puzzle);
+                }
+            }
+            job_release(job);
+            break;
+        }
+            
         case WM_CLOSE:
             // User clicked the X button or pressed Alt+F4
+            // Stop any background search before leaving; jobs that end
+            // now are only released, their results aren't shown
+            solve_job = NULL;
+            generate_job = NULL;
+            jobs_stop();
             PostQuitMessage(0);
             break;
             
@@ -393,18 +477,8 @@ void ClearGrid(HWND hwnd) {
 
 // Load an example Sudoku puzzle
 void LoadExamplePuzzle(HWND hwnd) {
-    // Medium difficulty puzzle
-    int example[SIZE][SIZE] = {
-        {5, 3, 0, 0, 7, 0, 0, 0, 0},
-        {6, 0, 0, 1, 9, 5, 0, 0, 0},
-        {0, 9, 8, 0, 0, 0, 0, 6, 0},
-        {8, 0, 0, 0, 6, 0, 0, 0, 3},
-        {4, 0, 0, 8, 0, 3, 0, 0, 1},
-        {7, 0, 0, 0, 2, 0, 0, 0, 6},
-        {0, 6, 0, 0, 0, 0, 2, 8, 0},
-        {0, 0, 0, 4, 1, 9, 0, 0, 5},
-        {0, 0, 0, 0, 8, 0, 0, 7, 9}
-    };
+    // Medium difficulty puzzle (example_puzzle in tables.c)
+    const int (*example)[SIZE] = example_puzzle;
     
     // Load the example into the grid
     for (int row = 0; row < SIZE; row++) {
@@ -500,6 +574,14 @@ void CreateGameTab(HWND hwnd) {
     ShowGameTab(hwnd, FALSE);
 }
 
+// Put a freshly generated puzzle on the board and start a new game
+void ShowNewPuzzle(HWND hwnd, int puzzle[SIZE][SIZE]) {
+    SetGridToGUI(hwnd, puzzle);
+    hints_left = MAX_HINTS; // Reset hints
+    has_puzzle = 1; // Mark that we have a puzzle with known solution
+    MessageBox(hwnd, "New puzzle generated! Try to solve it.", "New Puzzle", MB_OK | MB_ICONINFORMATION);
+}
+
 void GenerateSudokuPuzzle(int puzzle[SIZE][SIZE], int solution[SIZE][SIZE]) {
     // Initialize random seed
     srand((unsigned int)time(NULL));
@@ -509,28 +591,9 @@ void GenerateSudokuPuzzle(int puzzle[SIZE][SIZE], int solution[SIZE][SIZE]) {
         // Create puzzle by removing numbers (medium difficulty = 1)
         create_puzzle_from_solution(solution, puzzle, 1);
     } else {
-        // Fallback to example puzzle if generation fails
-        int example[SIZE][SIZE] = {
-            {5, 3, 0, 0, 7, 0, 0, 0, 0},
-            {6, 0, 0, 1, 9, 5, 0, 0, 0},
-            {0, 9, 8, 0, 0, 0, 0, 6, 0},
-            {8, 0, 0, 0, 6, 0, 0, 0, 3},
-            {4, 0, 0, 8, 0, 3, 0, 0, 1},
-            {7, 0, 0, 0, 2, 0, 0, 0, 6},
-            {0, 6, 0, 0, 0, 0, 2, 8, 0},
-            {0, 0, 0, 4, 1, 9, 0, 0, 5},
-            {0, 0, 0, 0, 8, 0, 0, 7, 9}
-        };
-        
-        // Copy example to puzzle
-        for (int i = 0; i < SIZE; i++) {
-            for (int j = 0; j < SIZE; j++) {
-                puzzle[i][j] = example[i][j];
-                solution[i][j] = example[i][j];
-            }
-        }
-        
-        // Solve to get the complete solution
-        solve_sudoku(solution);
+        // Fallback to the example puzzle if generation fails. Its solution
+        // was worked out by tools/gentables.c, so nothing is solved here.
+        memcpy(puzzle, example_puzzle, sizeof(example_puzzle));
+        memcpy(solution, example_solution, sizeof(example_solution));
     }
 }
@@ -13,6 +13,7 @@
 #define BOX_SPACING 8
 #define GRID_START_X 50
 #define GRID_START_Y 80
+#define WINDOW_TITLE "Sudoku Solver - C Project"
 
 // Control IDs for buttons
 #define ID_SOLVE_BUTTON 1001
@@ -35,6 +36,10 @@
 #define ID_GENERATE 5005
 #define ID_GAME_TAB 5006
 
+// Messages posted by background jobs (see jobs.h)
+#define WM_JOB_PROGRESS (WM_APP + 1)   // wParam = depth, lParam = thousands of nodes
+#define WM_JOB_DONE     (WM_APP + 2)   // lParam = the finished sudoku_job
+
 // Function declarations for GUI management
 LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
 void CreateSudokuGrid(HWND hwnd);
@@ -48,6 +53,7 @@ void ShowSolverTab(HWND hwnd, BOOL show);
 void ShowGameTab(HWND hwnd, BOOL show);
 void CreateGameTab(HWND hwnd);
 void GenerateSudokuPuzzle(int puzzle[SIZE][SIZE], int solution[SIZE][SIZE]);
+void ShowNewPuzzle(HWND hwnd, int puzzle[SIZE][SIZE]);
 void GiveHint(HWND hwnd);
 void CheckUserSolution(HWND hwnd);
 
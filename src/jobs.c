@@ -0,0 +1,454 @@
+// Must come before the first #include: older mingw-w64 headers default to
+// XP (0x0502) and then hide SRW locks, condition variables and GetTickCount64
+#ifdef _WIN32
+#if !defined(_WIN32_WINNT) || _WIN32_WINNT < 0x0600
+#undef _WIN32_WINNT
+#define _WIN32_WINNT 0x0600   // Vista+
+#endif
+#else
+#define _POSIX_C_SOURCE 200112L   // pthreads and clock_gettime under -std=c99
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "jobs.h"
+#include "enumerate.h"
+#include "trace.h"
+
+// Small platform layer: a lock, condition variables and worker threads.
+// Both lock types can be initialized statically, so the first submit can
+// start the pool without a separate init call.
+#ifdef _WIN32
+
+#include <windows.h>
+#include <process.h>
+
+typedef SRWLOCK job_lock;
+typedef CONDITION_VARIABLE job_cond;
+typedef HANDLE job_thread;
+#define JOB_LOCK_INIT SRWLOCK_INIT
+#define JOB_COND_INIT CONDITION_VARIABLE_INIT
+
+static void lock(job_lock *l) { AcquireSRWLockExclusive(l); }
+static void unlock(job_lock *l) { ReleaseSRWLockExclusive(l); }
+static void cond_wait(job_cond *c, job_lock *l) { SleepConditionVariableSRW(c, l, INFINITE, 0); }
+static void cond_broadcast(job_cond *c) { WakeAllConditionVariable(c); }
+
+static unsigned long long now_ms(void) {
+    return GetTickCount64();
+}
+
+static void cond_wait_until(job_cond *c, job_lock *l, unsigned long long deadline) {
+    unsigned long long now = now_ms();
+    if (now < deadline) {
+        SleepConditionVariableSRW(c, l, (DWORD)(deadline - now), 0);
+    }
+}
+
+static unsigned __stdcall worker_main(void *arg);
+
+static int thread_start(job_thread *t) {
+    *t = (HANDLE)_beginthreadex(NULL, 0, worker_main, NULL, 0, NULL);
+    return *t != 0;
+}
+
+static void thread_join(job_thread t) {
+    WaitForSingleObject(t, INFINITE);
+    CloseHandle(t);
+}
+
+#else
+
+#include <pthread.h>
+
+typedef pthread_mutex_t job_lock;
+typedef pthread_cond_t job_cond;
+typedef pthread_t job_thread;
+#define JOB_LOCK_INIT PTHREAD_MUTEX_INITIALIZER
+#define JOB_COND_INIT PTHREAD_COND_INITIALIZER
+
+static void lock(job_lock *l) { pthread_mutex_lock(l); }
+static void unlock(job_lock *l) { pthread_mutex_unlock(l); }
+static void cond_wait(job_cond *c, job_lock *l) { pthread_cond_wait(c, l); }
+static void cond_broadcast(job_cond *c) { pthread_cond_broadcast(c); }
+
+// Wall-clock milliseconds, the clock pthread_cond_timedwait uses
+static unsigned long long now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (unsigned long long)ts.tv_sec * 1000ull + (unsigned long long)ts.tv_nsec / 1000000ull;
+}
+
+static void cond_wait_until(job_cond *c, job_lock *l, unsigned long long deadline) {
+    struct timespec ts;
+    ts.tv_sec = (time_t)(deadline / 1000ull);
+    ts.tv_nsec = (long)(deadline % 1000ull) * 1000000L;
+    pthread_cond_timedwait(c, l, &ts);
+}
+
+static void *worker_main(void *arg);
+
+static int thread_start(job_thread *t) {
+    return pthread_create(t, NULL, worker_main, NULL) == 0;
+}
+
+static void thread_join(job_thread t) {
+    pthread_join(t, NULL);
+}
+
+#endif
+
+struct sudoku_job {
+    int type;
+    int state;
+    int cancel_requested;
+    int refs;                          // Caller's handle plus the pool's
+    unsigned long long max_solutions;  // Count jobs, 0 = no limit
+    int difficulty;                    // Generate jobs
+    solve_state *resolve_state;        // Resolve jobs, owned by the job while it runs
+    unsigned long long progress_nodes; // Latest progress, for job_poll
+    int progress_depth;
+    job_callbacks cb;
+    job_result result;                 // Only read by others once the job has ended
+    sudoku_job *next;                  // Next job in the queue
+};
+
+// Everything below is guarded by pool_lock
+static job_lock pool_lock = JOB_LOCK_INIT;
+static job_cond work_ready = JOB_COND_INIT;    // A job was queued or the pool is stopping
+static job_cond job_ended = JOB_COND_INIT;     // Some job finished or was cancelled
+static job_thread workers[JOB_MAX_WORKERS];
+static int worker_count = 0;
+static int stopping = 0;
+static sudoku_job *queue_head = NULL;
+static sudoku_job *queue_tail = NULL;
+
+// generate_complete_sudoku keeps a seed pool and uses rand(), neither of
+// which is thread-safe, so generate jobs take turns
+static job_lock generate_lock = JOB_LOCK_INIT;
+static unsigned int workers_seeded = 0;   // Guarded by generate_lock
+
+// Start the pool with pool_lock held
+static int start_locked(int count) {
+    if (worker_count > 0) {
+        return worker_count;
+    }
+    if (count < 1) count = 1;
+    if (count > JOB_MAX_WORKERS) count = JOB_MAX_WORKERS;
+
+    stopping = 0;
+    while (worker_count < count && thread_start(&workers[worker_count])) {
+        worker_count++;
+    }
+    return worker_count;
+}
+
+// Start count worker threads. Returns the number running.
+int jobs_start(int workers_wanted) {
+    lock(&pool_lock);
+    int count = start_locked(workers_wanted);
+    unlock(&pool_lock);
+    return count;
+}
+
+// Cancel everything still queued, let running jobs stop and join the workers
+void jobs_stop(void) {
+    lock(&pool_lock);
+    int count = worker_count;
+    stopping = 1;
+    for (sudoku_job *job = queue_head; job; job = job->next) {
+        job->cancel_requested = 1;
+    }
+    cond_broadcast(&work_ready);
+    unlock(&pool_lock);
+
+    for (int i = 0; i < count; i++) {
+        thread_join(workers[i]);
+    }
+
+    lock(&pool_lock);
+    worker_count = 0;
+    stopping = 0;
+    unlock(&pool_lock);
+}
+
+static int is_cancelled(sudoku_job *job) {
+    lock(&pool_lock);
+    int cancelled = job->cancel_requested || stopping;
+    unlock(&pool_lock);
+    return cancelled;
+}
+
+static void report_progress(sudoku_job *job, unsigned long long nodes, int depth) {
+    lock(&pool_lock);
+    job->progress_nodes = nodes;
+    job->progress_depth = depth;
+    unlock(&pool_lock);
+
+    if (job->cb.progress) {
+        job->cb.progress(job, nodes, depth, job->cb.user);
+    }
+}
+
+// Solve and count jobs: run the enumerator in slices of JOB_SLICE_NODES so
+// the job can report progress and notice a cancel between slices.
+// Returns 0 if the job was cancelled.
+static int run_search(sudoku_job *job) {
+    job_result *r = &job->result;
+    sudoku_enum e;
+    int solution[SIZE][SIZE];
+    unsigned long long last_report = 0;
+
+    if (!enum_init(&e, r->puzzle)) {
+        return 1; // Invalid clues: no solutions
+    }
+
+    for (;;) {
+        int status = enum_next_limited(&e, solution, JOB_SLICE_NODES);
+        if (status == ENUM_DONE) {
+            break;
+        }
+        if (status == ENUM_FOUND) {
+            if (r->solutions++ == 0) {
+                memcpy(r->solution, solution, sizeof(r->solution));
+            }
+            if (job->type != JOB_COUNT ||
+                (job->max_solutions != 0 && r->solutions >= job->max_solutions)) {
+                break;
+            }
+        }
+        if (e.nodes - last_report >= JOB_SLICE_NODES) {
+            last_report = e.nodes;
+            r->nodes = e.nodes;
+            report_progress(job, e.nodes, e.depth);
+            if (is_cancelled(job)) {
+                return 0;
+            }
+        }
+    }
+
+    r->nodes = e.nodes;
+    r->solved = r->solutions > 0;
+    return 1;
+}
+
+// seeded is the worker's own flag. The C runtime on Windows keeps rand()
+// state per thread, starting from seed 1, so the srand() done by the UI
+// thread doesn't reach the workers: each one seeds itself on its first
+// generate job, with a different seed per worker.
+static int run_generate(sudoku_job *job, int *seeded) {
+    job_result *r = &job->result;
+
+    lock(&generate_lock);
+    if (!*seeded) {
+        srand((unsigned int)time(NULL) + 7919u * workers_seeded++);
+        *seeded = 1;
+    }
+    r->solved = generate_complete_sudoku(r->solution);
+    if (r->solved) {
+        create_puzzle_from_solution(r->solution, r->puzzle, job->difficulty);
+    }
+    unlock(&generate_lock);
+    return 1;
+}
+
+// Resolve jobs: reuse the old solution if the warm start can, otherwise
+// solve cold as a sliced search so the job can still be cancelled
+static int run_resolve(sudoku_job *job) {
+    job_result *r = &job->result;
+    solve_state *st = job->resolve_state;
+
+    int status = resolve_from_grid_warm(st, r->puzzle);
+    if (status != RESOLVE_COLD) {
+        r->solved = status;
+        r->solutions = (unsigned long long)status;
+        if (status) memcpy(r->solution, st->solution, sizeof(r->solution));
+        return 1;
+    }
+
+    if (!run_search(job)) {
+        st->ready = 0; // No answer for st->puzzle: start cold next time
+        return 0;
+    }
+    solve_state_set(st, r->solution, r->solved);
+    return 1;
+}
+
+// Drop one reference, freeing the job with the last one. Called with pool_lock held.
+static void release_locked(sudoku_job *job) {
+    if (--job->refs == 0) {
+        free(job);
+    }
+}
+
+#ifdef _WIN32
+static unsigned __stdcall worker_main(void *arg) {
+#else
+static void *worker_main(void *arg) {
+#endif
+    int seeded = 0;   // This thread has called srand()
+    (void)arg;
+
+    lock(&pool_lock);
+    for (;;) {
+        while (!queue_head && !stopping) {
+            cond_wait(&work_ready, &pool_lock);
+        }
+        if (!queue_head) {
+            break; // Stopping and nothing left to drain
+        }
+
+        sudoku_job *job = queue_head;
+        queue_head = job->next;
+        if (!queue_head) queue_tail = NULL;
+        job->next = NULL;
+        if (stopping) job->cancel_requested = 1;
+        int skip = job->cancel_requested;
+        job->state = skip ? JOB_CANCELLED : JOB_RUNNING;
+        unlock(&pool_lock);
+
+        int completed = 0;
+        if (!skip) {
+            if (job->type == JOB_GENERATE) {
+                completed = run_generate(job, &seeded);
+            } else if (job->type == JOB_RESOLVE) {
+                completed = run_resolve(job);
+            } else {
+                completed = run_search(job);
+            }
+        }
+
+        // Write this worker's events before the job is seen to end, so a
+        // caller that waits for it and then calls trace_close loses none
+        trace_flush();
+
+        lock(&pool_lock);
+        job->state = completed ? JOB_FINISHED : JOB_CANCELLED;
+        job->result.state = job->state;
+        cond_broadcast(&job_ended);
+        unlock(&pool_lock);
+
+        if (job->cb.done) {
+            job->cb.done(job, job->cb.user);
+        }
+
+        lock(&pool_lock);
+        release_locked(job);
+    }
+    unlock(&pool_lock);
+    return 0;
+}
+
+// Create a job and queue it. The caller and the pool each hold a reference.
+static sudoku_job *submit(int type, int grid[SIZE][SIZE], unsigned long long max_solutions,
+                          int difficulty, solve_state *st, const job_callbacks *cb) {
+    sudoku_job *job = calloc(1, sizeof(*job));
+    if (!job) {
+        return NULL;
+    }
+    job->type = type;
+    job->state = JOB_QUEUED;
+    job->refs = 2;
+    job->max_solutions = max_solutions;
+    job->difficulty = difficulty;
+    job->resolve_state = st;
+    if (cb) job->cb = *cb;
+    if (grid) memcpy(job->result.puzzle, grid, sizeof(job->result.puzzle));
+
+    lock(&pool_lock);
+    if (start_locked(JOB_DEFAULT_WORKERS) == 0) {
+        unlock(&pool_lock);
+        free(job);
+        return NULL;
+    }
+    if (queue_tail) {
+        queue_tail->next = job;
+    } else {
+        queue_head = job;
+    }
+    queue_tail = job;
+    cond_broadcast(&work_ready);
+    unlock(&pool_lock);
+    return job;
+}
+
+sudoku_job *job_submit_solve(int grid[SIZE][SIZE], const job_callbacks *cb) {
+    return submit(JOB_SOLVE, grid, 0, 0, NULL, cb);
+}
+
+// Count solutions, stopping at max_solutions (0 = count them all)
+sudoku_job *job_submit_count(int grid[SIZE][SIZE], unsigned long long max_solutions, const job_callbacks *cb) {
+    return submit(JOB_COUNT, grid, max_solutions, 0, NULL, cb);
+}
+
+// Generate a puzzle; difficulty as in create_puzzle_from_solution (0-2)
+sudoku_job *job_submit_generate(int difficulty, const job_callbacks *cb) {
+    return submit(JOB_GENERATE, NULL, 0, difficulty, NULL, cb);
+}
+
+// Solve grid, warm-starting from st
+sudoku_job *job_submit_resolve(solve_state *st, int grid[SIZE][SIZE], const job_callbacks *cb) {
+    return submit(JOB_RESOLVE, grid, 0, 0, st, cb);
+}
+
+int job_poll(sudoku_job *job, unsigned long long *nodes, int *depth) {
+    lock(&pool_lock);
+    int state = job->state;
+    if (nodes) *nodes = job->progress_nodes;
+    if (depth) *depth = job->progress_depth;
+    unlock(&pool_lock);
+    return state;
+}
+
+static int has_ended(const sudoku_job *job) {
+    return job->state == JOB_FINISHED || job->state == JOB_CANCELLED;
+}
+
+int job_wait(sudoku_job *job, int timeout_ms) {
+    unsigned long long deadline = timeout_ms < 0 ? 0 : now_ms() + (unsigned long long)timeout_ms;
+
+    lock(&pool_lock);
+    while (!has_ended(job)) {
+        if (timeout_ms < 0) {
+            cond_wait(&job_ended, &pool_lock);
+        } else if (now_ms() >= deadline) {
+            break;
+        } else {
+            cond_wait_until(&job_ended, &pool_lock, deadline);
+        }
+    }
+    int state = job->state;
+    unlock(&pool_lock);
+    return state;
+}
+
+void job_cancel(sudoku_job *job) {
+    lock(&pool_lock);
+    if (!has_ended(job)) {
+        job->cancel_requested = 1;
+    }
+    unlock(&pool_lock);
+}
+
+int job_get_result(sudoku_job *job, job_result *result) {
+    lock(&pool_lock);
+    int ended = has_ended(job);
+    if (ended) {
+        *result = job->result;
+    }
+    unlock(&pool_lock);
+    return ended;
+}
+
+void job_release(sudoku_job *job) {
+    if (!job) {
+        return;
+    }
+    lock(&pool_lock);
+    if (!has_ended(job)) {
+        job->cancel_requested = 1;
+    }
+    release_locked(job);
+    unlock(&pool_lock);
+}
@@ -0,0 +1,83 @@
+#ifndef JOBS_H
+#define JOBS_H
+
+#include "sudoku.h"
+#include "resolve.h"
+
+// Background jobs: solve, re-solve, count and generate run on a small pool of worker
+// threads (Win32 threads on Windows, pthreads elsewhere) so front-ends never
+// block on a long search. Each submit returns a handle that can be polled,
+// waited on with a timeout and cancelled. The handle stays valid until
+// job_release is called.
+
+#define JOB_DEFAULT_WORKERS 2     // Pool size when jobs_start isn't called
+#define JOB_MAX_WORKERS 16
+#define JOB_SLICE_NODES 65536     // Nodes searched between progress reports and cancel checks
+
+// Job types
+#define JOB_SOLVE    0   // Find one solution of a puzzle
+#define JOB_COUNT    1   // Count solutions of a puzzle (up to a limit)
+#define JOB_GENERATE 2   // Generate a new puzzle and its solution
+#define JOB_RESOLVE  3   // Solve a puzzle, warm-starting from a solve_state
+
+// Job states
+#define JOB_QUEUED    0
+#define JOB_RUNNING   1
+#define JOB_FINISHED  2
+#define JOB_CANCELLED 3
+
+typedef struct sudoku_job sudoku_job;
+
+// Called on the worker thread about every JOB_SLICE_NODES nodes
+typedef void (*job_progress_callback)(sudoku_job *job, unsigned long long nodes, int depth, void *user);
+
+// Called on the worker thread once the job is finished or cancelled
+typedef void (*job_done_callback)(sudoku_job *job, void *user);
+
+// Optional callbacks for a job; either function may be NULL
+typedef struct {
+    job_progress_callback progress;
+    job_done_callback done;
+    void *user;
+} job_callbacks;
+
+typedef struct {
+    int state;                      // JOB_FINISHED or JOB_CANCELLED
+    int solved;                     // Solve/count: a solution was found. Generate: success.
+    unsigned long long solutions;   // Solutions found (count jobs stop at their limit)
+    unsigned long long nodes;       // Placements tried by the search
+    int puzzle[SIZE][SIZE];         // Input puzzle, or the generated puzzle
+    int solution[SIZE][SIZE];       // First solution found, or the generated solution
+} job_result;
+
+// Pool control. jobs_start is optional (the first submit starts a pool of
+// JOB_DEFAULT_WORKERS); jobs_stop cancels queued jobs and joins the workers.
+int jobs_start(int workers);
+void jobs_stop(void);
+
+// Submit a job. cb may be NULL. Returns NULL if the pool can't be started.
+sudoku_job *job_submit_solve(int grid[SIZE][SIZE], const job_callbacks *cb);
+sudoku_job *job_submit_count(int grid[SIZE][SIZE], unsigned long long max_solutions, const job_callbacks *cb);
+sudoku_job *job_submit_generate(int difficulty, const job_callbacks *cb);
+
+// Solve grid as an edit of the puzzle remembered in st (see resolve.h). The
+// job owns st until it ends: the caller must not use or submit it again
+// before then. A cancelled job leaves st ready for a cold solve next time.
+sudoku_job *job_submit_resolve(solve_state *st, int grid[SIZE][SIZE], const job_callbacks *cb);
+
+// Current state, plus the latest progress if nodes/depth are not NULL
+int job_poll(sudoku_job *job, unsigned long long *nodes, int *depth);
+
+// Wait up to timeout_ms milliseconds (-1 = forever). Returns the job state.
+int job_wait(sudoku_job *job, int timeout_ms);
+
+// Ask the job to stop; it ends as JOB_CANCELLED unless it already finished
+void job_cancel(sudoku_job *job);
+
+// Copy the result of a finished or cancelled job. Returns 0 if still running.
+int job_get_result(sudoku_job *job, job_result *result);
+
+// Drop the caller's handle. A running job is cancelled first.
+void job_release(sudoku_job *job);
+
+#endif
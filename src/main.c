@@ -26,7 +26,7 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
       // Create the main window with a fixed size (non-resizable)
     HWND hwnd = CreateWindow(
         "SudokuSolver",              // Window class name
-        "Sudoku Solver - C Project", // Window title
+        WINDOW_TITLE,                // Window title
         WS_OVERLAPPED | WS_CAPTION | WS_SYSMENU | WS_MINIMIZEBOX,  // Fixed size window style
         (GetSystemMetrics(SM_CXSCREEN) - WINDOW_WIDTH) / 2,  // Center horizontally 
         (GetSystemMetrics(SM_CYSCREEN) - WINDOW_HEIGHT) / 2, // Center vertically
@@ -0,0 +1,138 @@
+#include <string.h>
+#include "resolve.h"
+#include "tables.h"
+
+// Solve puzzle from scratch and remember the result in st
+int solve_state_init(solve_state *st, int puzzle[SIZE][SIZE]) {
+    memcpy(st->puzzle, puzzle, sizeof(st->puzzle));
+    memcpy(st->solution, puzzle, sizeof(st->solution));
+    st->solved = is_grid_valid(st->solution) && solve_sudoku(st->solution);
+    st->ready = 1;
+    return st->solved;
+}
+
+// Record the outcome of a cold solve of st->puzzle done by the caller
+void solve_state_set(solve_state *st, int solution[SIZE][SIZE], int solved) {
+    if (solved) {
+        memcpy(st->solution, solution, sizeof(st->solution));
+    }
+    st->solved = solved;
+    st->ready = 1;
+}
+
+// Clear every non-clue cell that shares a row, column or box with (row, col)
+static void clear_region(int grid[SIZE][SIZE], int puzzle[SIZE][SIZE], int row, int col) {
+    int cell = row * SIZE + col;
+
+    for (int p = 0; p < NUM_PEERS; p++) {
+        int r = peer_cells[cell][p] / SIZE;
+        int c = peer_cells[cell][p] % SIZE;
+        if (puzzle[r][c] == 0) {
+            grid[r][c] = 0;
+        }
+    }
+}
+
+// Apply changes and re-solve from the old solution, leaving cold solves
+// to the caller
+int resolve_sudoku_warm(solve_state *st, const clue_change changes[], int count) {
+    int conflicts = 0;
+    int removed = 0;
+
+    if (!st->ready) {
+        // Nothing to warm-start from: apply the edits to an empty grid
+        memset(st->puzzle, 0, sizeof(st->puzzle));
+        for (int i = 0; i < count; i++) {
+            st->puzzle[changes[i].row][changes[i].col] = changes[i].value;
+        }
+        return RESOLVE_COLD;
+    }
+
+    // Apply the edits, checking each one against the old solution - O(changes)
+    for (int i = 0; i < count; i++) {
+        int row = changes[i].row, col = changes[i].col, value = changes[i].value;
+        if (st->puzzle[row][col] != 0 && st->puzzle[row][col] != value) {
+            removed++; // Clearing or replacing a clue drops the old one
+        }
+        st->puzzle[row][col] = value;
+        if (value != 0 && (!st->solved || st->solution[row][col] != value)) {
+            conflicts++;
+        }
+    }
+
+    if (st->solved && conflicts == 0) {
+        return 1; // Old solution still fits every clue
+    }
+    if (!st->solved && removed == 0) {
+        return 0; // Only added clues: still unsolvable
+    }
+    if (!st->solved) {
+        return RESOLVE_COLD; // No old solution to reuse
+    }
+
+    // Warm start: keep the old solution outside the rows, columns and boxes
+    // touched by conflicting clues and only search the cleared region
+    int grid[SIZE][SIZE];
+    memcpy(grid, st->solution, sizeof(grid));
+    for (int i = 0; i < count; i++) {
+        int row = changes[i].row, col = changes[i].col, value = changes[i].value;
+        if (value != 0 && st->solution[row][col] != value) {
+            clear_region(grid, st->puzzle, row, col);
+            grid[row][col] = value;
+        }
+    }
+
+    if (is_grid_valid(grid) && solve_sudoku(grid)) {
+        memcpy(st->solution, grid, sizeof(grid));
+        return 1;
+    }
+
+    return RESOLVE_COLD; // The kept cells ruled out every answer for the region
+}
+
+// Apply changes to the remembered puzzle and re-solve it
+int resolve_sudoku(solve_state *st, const clue_change changes[], int count) {
+    int status = resolve_sudoku_warm(st, changes, count);
+    if (status == RESOLVE_COLD) {
+        return solve_state_init(st, st->puzzle);
+    }
+    return status;
+}
+
+// Changes that turn the remembered puzzle into puzzle. Returns the count.
+static int diff_puzzle(const solve_state *st, int puzzle[SIZE][SIZE], clue_change changes[NUM_CELLS]) {
+    int count = 0;
+
+    for (int row = 0; row < SIZE; row++) {
+        for (int col = 0; col < SIZE; col++) {
+            if (puzzle[row][col] != st->puzzle[row][col]) {
+                changes[count].row = row;
+                changes[count].col = col;
+                changes[count].value = puzzle[row][col];
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+// Re-solve puzzle, working out the changes from the remembered puzzle
+int resolve_from_grid(solve_state *st, int puzzle[SIZE][SIZE]) {
+    clue_change changes[NUM_CELLS];
+
+    if (!st->ready) {
+        return solve_state_init(st, puzzle);
+    }
+    return resolve_sudoku(st, changes, diff_puzzle(st, puzzle, changes));
+}
+
+// Warm-start half of resolve_from_grid
+int resolve_from_grid_warm(solve_state *st, int puzzle[SIZE][SIZE]) {
+    clue_change changes[NUM_CELLS];
+
+    if (!st->ready) {
+        memcpy(st->puzzle, puzzle, sizeof(st->puzzle));
+        return RESOLVE_COLD;
+    }
+    return resolve_sudoku_warm(st, changes, diff_puzzle(st, puzzle, changes));
+}
@@ -0,0 +1,43 @@
+#ifndef RESOLVE_H
+#define RESOLVE_H
+
+#include "sudoku.h"
+
+// Result of the last solve, kept so that small clue edits can be re-solved
+// without starting from scratch
+typedef struct {
+    int puzzle[SIZE][SIZE];     // Clues of the last solve
+    int solution[SIZE][SIZE];   // Solution found for those clues (if solved)
+    int solved;                 // 1 if solution satisfies puzzle
+    int ready;                  // 0 until the first solve has been done
+} solve_state;
+
+// One edited clue; value 0 means the clue was removed
+typedef struct {
+    int row;
+    int col;
+    int value;
+} clue_change;
+
+// Solve puzzle from scratch and remember the result in st
+int solve_state_init(solve_state *st, int puzzle[SIZE][SIZE]);
+
+// Apply changes to the remembered puzzle and re-solve it, reusing the old
+// solution wherever the changes don't reach. Returns 1 if solved.
+int resolve_sudoku(solve_state *st, const clue_change changes[], int count);
+
+// Same as resolve_sudoku, with the changes taken from the difference
+// between the remembered puzzle and puzzle
+int resolve_from_grid(solve_state *st, int puzzle[SIZE][SIZE]);
+
+// Warm-start halves of resolve_sudoku and resolve_from_grid, for callers
+// that run cold solves themselves (e.g. as a cancellable background job).
+// They return 1 or 0 like the functions above, or RESOLVE_COLD when the old
+// solution can't be reused; st->puzzle then holds the new clues, and the
+// caller solves it and records the outcome with solve_state_set.
+#define RESOLVE_COLD (-1)
+int resolve_sudoku_warm(solve_state *st, const clue_change changes[], int count);
+int resolve_from_grid_warm(solve_state *st, int puzzle[SIZE][SIZE]);
+void solve_state_set(solve_state *st, int solution[SIZE][SIZE], int solved);
+
+#endif
@@ -3,6 +3,8 @@
 #include <stdlib.h>
 #include <time.h>
 #include "sudoku.h"
+#include "tables.h"
+#include "trace.h"
 
 // Check if placing num at grid[row][col] is valid
 int is_valid(int grid[SIZE][SIZE], int row, int col, int num) {
@@ -21,8 +23,9 @@ int is_valid(int grid[SIZE][SIZE], int row, int col, int num) {
     }
     
     // Check 3x3 box - no duplicate numbers in the same 3x3 section
-    int start_row = row - row % 3;  // Find top-left corner of the 3x3 box
-    int start_col = col - col % 3;
+    int box = box_of_cell[row * SIZE + col];  // Top-left corner of the 3x3 box, from the tables
+    int start_row = box_top[box];
+    int start_col = box_left[box];
     
     for (int i = 0; i < 3; i++) {
         for (int j = 0; j < 3; j++) {
@@ -35,8 +38,8 @@ int is_valid(int grid[SIZE][SIZE], int row, int col, int num) {
     return 1; // Valid placement - all sudoku rules satisfied
 }
 
-// Solve sudoku using backtracking algorithm
-int solve_sudoku(int grid[SIZE][SIZE]) {
+// Backtracking search; depth is the number of cells filled so far (used for tracing)
+static int solve_from(int grid[SIZE][SIZE], int depth) {
     int row, col;
     
     // Find the first empty cell (represented by 0)
@@ -55,6 +58,7 @@ int solve_sudoku(int grid[SIZE][SIZE]) {
     if (!found_empty) {
         return 1; // Success! All cells are filled
     }
+    TRACE_EVENT(TRACE_DECISION, row * SIZE + col, 0, depth);
     
     // Try numbers 1 through 9 in the empty cell
     for (int num = 1; num <= 9; num++) {
@@ -62,9 +66,10 @@ int solve_sudoku(int grid[SIZE][SIZE]) {
         if (is_valid(grid, row, col, num)) {
             // Place the number temporarily
             grid[row][col] = num;
+            TRACE_EVENT(TRACE_ASSIGN, row * SIZE + col, num, depth);
             
             // Recursively try to solve the rest of the puzzle
-            if (solve_sudoku(grid)) {
+            if (solve_from(grid, depth + 1)) {
                 return 1; // Solution found!
             }
             
@@ -75,9 +80,15 @@ int solve_sudoku(int grid[SIZE][SIZE]) {
     }
     
     // No number 1-9 worked in this position, so backtrack
+    TRACE_EVENT(TRACE_BACKTRACK, row * SIZE + col, 0, depth);
     return 0;
 }
 
+// Solve sudoku using backtracking algorithm
+int solve_sudoku(int grid[SIZE][SIZE]) {
+    return solve_from(grid, 0);
+}
+
 // Print the grid to console (useful for debugging)
 void print_grid(int grid[SIZE][SIZE]) {
     printf("\nSudoku Grid:\n");
@@ -183,8 +194,8 @@ int fill_diagonal_boxes(int grid[SIZE][SIZE]) {
     return 1;
 }
 
-// Generate a complete valid sudoku solution
-int generate_complete_sudoku(int grid[SIZE][SIZE]) {
+// Generate a complete valid sudoku solution from scratch with the backtracking solver
+int generate_complete_sudoku_backtrack(int grid[SIZE][SIZE]) {
     // Clear the grid first
     for (int i = 0; i < SIZE; i++) {
         for (int j = 0; j < SIZE; j++) {
@@ -199,6 +210,76 @@ int generate_complete_sudoku(int grid[SIZE][SIZE]) {
     return solve_sudoku(grid);
 }
 
+// Build a random row (or column) order that keeps every row inside a band:
+// shuffle the three bands, then shuffle the rows inside each band
+static void random_band_order(int order[SIZE]) {
+    int bands[3] = {0, 1, 2};
+    shuffle_array(bands, 3);
+
+    for (int band = 0; band < 3; band++) {
+        int rows[3] = {0, 1, 2};
+        shuffle_array(rows, 3);
+        for (int i = 0; i < 3; i++) {
+            order[band * 3 + i] = bands[band] * 3 + rows[i];
+        }
+    }
+}
+
+// Copy src into dst with a random mix of transformations that keep a solved
+// grid valid: digit relabelling, row swaps within bands, column swaps within
+// stacks, band and stack swaps, and transposition
+void transform_grid(int src[SIZE][SIZE], int dst[SIZE][SIZE]) {
+    int digits[SIZE + 1] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    int row_order[SIZE];
+    int col_order[SIZE];
+
+    shuffle_array(digits + 1, SIZE);  // digits[old] = new label, 0 stays empty
+    random_band_order(row_order);
+    random_band_order(col_order);
+    int transpose = rand() % 2;
+
+    for (int i = 0; i < SIZE; i++) {
+        for (int j = 0; j < SIZE; j++) {
+            int value = transpose ? src[col_order[j]][row_order[i]] : src[row_order[i]][col_order[j]];
+            dst[i][j] = digits[value];
+        }
+    }
+}
+
+// Pool of backtracked seed grids that new grids are transformed from.
+// One seed is replaced by a freshly backtracked grid every SEED_POOL_REFRESH
+// generated grids so the output doesn't stay in the same few families.
+// Not guarded: generation callers must not run concurrently (see sudoku.h).
+static int seed_pool[SEED_POOL_SIZE][SIZE][SIZE];
+static int seed_count = 0;
+static int next_refresh_slot = 0;
+static int grids_since_refresh = 0;
+
+// Generate a complete valid sudoku solution
+int generate_complete_sudoku(int grid[SIZE][SIZE]) {
+    // While the pool is filling up, hand out the new backtracked seeds directly
+    if (seed_count < SEED_POOL_SIZE) {
+        if (!generate_complete_sudoku_backtrack(grid)) {
+            return 0;
+        }
+        memcpy(seed_pool[seed_count++], grid, sizeof(seed_pool[0]));
+        return 1;
+    }
+
+    // Periodically swap out the oldest seed to keep the pool diverse
+    if (++grids_since_refresh >= SEED_POOL_REFRESH) {
+        if (generate_complete_sudoku_backtrack(grid)) {
+            memcpy(seed_pool[next_refresh_slot], grid, sizeof(seed_pool[0]));
+            next_refresh_slot = (next_refresh_slot + 1) % SEED_POOL_SIZE;
+        }
+        grids_since_refresh = 0;
+    }
+
+    // Fast path: transform a random seed instead of searching
+    transform_grid(seed_pool[rand() % SEED_POOL_SIZE], grid);
+    return 1;
+}
+
 // Create a puzzle by removing numbers from a complete solution
 void create_puzzle_from_solution(int solution[SIZE][SIZE], int puzzle[SIZE][SIZE], int difficulty) {
     // Copy solution to puzzle
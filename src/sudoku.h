@@ -2,6 +2,14 @@
 #define SUDOKU_H
 
 #define SIZE 9
+#define NUM_CELLS (SIZE * SIZE)
+#define NUM_UNITS (3 * SIZE)   // 9 rows, 9 columns and 9 boxes
+#define NUM_PEERS 20           // Cells sharing a row, column or box with a cell
+
+// Complete-grid generation keeps this many backtracked seed grids and
+// replaces one of them after every SEED_POOL_REFRESH generated grids
+#define SEED_POOL_SIZE 8
+#define SEED_POOL_REFRESH 1024
 
 // Function declarations for sudoku solving logic
 int is_valid(int grid[SIZE][SIZE], int row, int col, int num);
@@ -10,10 +18,14 @@ void print_grid(int grid[SIZE][SIZE]);
 int is_grid_complete(int grid[SIZE][SIZE]);
 int is_grid_valid(int grid[SIZE][SIZE]);
 
-// Puzzle generation functions
+// Puzzle generation functions. They use rand(), and generate_complete_sudoku
+// also updates a shared seed pool, so none of them are thread-safe: callers
+// on several threads must serialize them (jobs.c does, behind generate_lock).
 void shuffle_array(int arr[], int n);
 int fill_diagonal_boxes(int grid[SIZE][SIZE]);
 int generate_complete_sudoku(int grid[SIZE][SIZE]);
+int generate_complete_sudoku_backtrack(int grid[SIZE][SIZE]);
+void transform_grid(int src[SIZE][SIZE], int dst[SIZE][SIZE]);
 void create_puzzle_from_solution(int solution[SIZE][SIZE], int puzzle[SIZE][SIZE], int difficulty);
 
 #endif
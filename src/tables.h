@@ -0,0 +1,34 @@
+#ifndef TABLES_H
+#define TABLES_H
+
+#include "sudoku.h"
+
+// Constant lookup tables, generated together with the built-in example's
+// solution by tools/gentables.c into tables.c (make tables). Nothing here
+// is built or solved at runtime.
+
+#define MAX_CAGE_SUM 45   // 1 + 2 + ... + 9
+
+// Cell indices (row * SIZE + col) of every unit and of every cell's peers.
+// Units are numbered rows 0-8, columns 9-17, boxes 18-26.
+extern const unsigned char unit_cells[NUM_UNITS][SIZE];
+extern const unsigned char peer_cells[NUM_CELLS][NUM_PEERS];
+
+// Box (0-8) of every cell, and the top row and left column of every box
+extern const unsigned char box_of_cell[NUM_CELLS];
+extern const unsigned char box_top[SIZE];
+extern const unsigned char box_left[SIZE];
+
+// One-hot digit bit of the low and high nibble of a packed grid byte
+extern const unsigned short low_cell_bit[256];
+extern const unsigned short high_cell_bit[256];
+
+// cage_combos[n][s]: every digit that appears in some set of n different
+// digits adding up to s (killer cages)
+extern const unsigned short cage_combos[SIZE + 1][MAX_CAGE_SUM + 1];
+
+// Built-in example puzzle and its (unique) solution
+extern const int example_puzzle[SIZE][SIZE];
+extern const int example_solution[SIZE][SIZE];
+
+#endif
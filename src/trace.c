@@ -0,0 +1,89 @@
+#include "trace.h"
+
+#ifdef SUDOKU_TRACE
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_MSC_VER)
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
+// Per-thread ring. The block header sits directly before the events so a
+// whole block goes out in a single fwrite call and blocks from different
+// threads never interleave in the file.
+typedef struct {
+    trace_block_header header;
+    trace_event events[TRACE_RING_SIZE];
+} trace_ring;
+
+static FILE *trace_file = NULL;
+static unsigned int next_thread_id = 0;
+static THREAD_LOCAL trace_ring ring;
+static THREAD_LOCAL unsigned int ring_seq = 0;
+static THREAD_LOCAL int ring_ready = 0;
+
+// Start writing trace events to path. Returns 1 on success.
+int trace_open(const char *path) {
+    trace_file_header header;
+
+    trace_file = fopen(path, "wb");
+    if (!trace_file) {
+        return 0;
+    }
+
+    memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    header.version = TRACE_VERSION;
+    header.event_size = sizeof(trace_event);
+    fwrite(&header, sizeof(header), 1, trace_file);
+    return 1;
+}
+
+// Write the calling thread's buffered events to the trace file
+void trace_flush(void) {
+    if (trace_file && ring.header.count > 0) {
+        fwrite(&ring, sizeof(ring.header) + ring.header.count * sizeof(trace_event), 1, trace_file);
+    }
+    ring.header.count = 0;
+}
+
+// Append one event to the calling thread's ring, flushing it when full
+void trace_record(int type, int cell, int value, int depth) {
+    if (!trace_file) {
+        return; // Tracing compiled in but not started
+    }
+
+    if (!ring_ready) {
+#if defined(__GNUC__)
+        ring.header.thread_id = __sync_fetch_and_add(&next_thread_id, 1);
+#else
+        ring.header.thread_id = next_thread_id++;
+#endif
+        ring_ready = 1;
+    }
+
+    trace_event *ev = &ring.events[ring.header.count++];
+    ev->type = (unsigned char)type;
+    ev->cell = (unsigned char)cell;
+    ev->value = (unsigned char)value;
+    ev->depth = (unsigned char)depth;
+    ev->seq = ring_seq++;
+
+    if (ring.header.count == TRACE_RING_SIZE) {
+        trace_flush();
+    }
+}
+
+// Flush the calling thread's events and close the file.
+// Other threads should call trace_flush before this.
+void trace_close(void) {
+    trace_flush();
+    if (trace_file) {
+        fclose(trace_file);
+        trace_file = NULL;
+    }
+}
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+// Optional binary search tracer for profiling slow puzzles offline.
+// Build with -DSUDOKU_TRACE (make TRACE=1) to enable it. Without that flag
+// every TRACE_* macro expands to nothing, so tracing costs nothing.
+//
+// Each thread records fixed-size events into its own ring buffer and
+// writes the ring out as one block whenever it fills up. Convert trace
+// files with tools/trace2json.
+
+// Event types
+#define TRACE_DECISION  1   // A cell was chosen for branching
+#define TRACE_ASSIGN    2   // A digit was placed in the cell
+#define TRACE_ELIMINATE 3   // A digit was removed from a cell's candidates
+#define TRACE_BACKTRACK 4   // Search returned to depth (depth = level resumed at)
+
+// File layout: trace_file_header, then blocks of trace_block_header + events
+#define TRACE_MAGIC "SDKTRACE"
+#define TRACE_VERSION 1
+#define TRACE_RING_SIZE 4096   // Events per thread buffer
+
+// One trace event (8 bytes)
+typedef struct {
+    unsigned char type;
+    unsigned char cell;    // row * SIZE + col
+    unsigned char value;   // Digit, 0 if not relevant
+    unsigned char depth;   // Search depth (decision level)
+    unsigned int seq;      // Per-thread event counter, used as the timestamp
+} trace_event;
+
+typedef struct {
+    char magic[8];
+    unsigned int version;
+    unsigned int event_size;
+} trace_file_header;
+
+typedef struct {
+    unsigned int thread_id;
+    unsigned int count;    // Number of events following this header
+} trace_block_header;
+
+#ifdef SUDOKU_TRACE
+
+int trace_open(const char *path);
+void trace_record(int type, int cell, int value, int depth);
+void trace_flush(void);
+void trace_close(void);
+
+#define TRACE_EVENT(type, cell, value, depth) trace_record((type), (cell), (value), (depth))
+
+#else
+
+#define trace_open(path) 0
+#define trace_flush() ((void)0)
+#define trace_close() ((void)0)
+#define TRACE_EVENT(type, cell, value, depth) ((void)0)
+
+#endif
+
+#endif
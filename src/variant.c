@@ -0,0 +1,264 @@
+#include <string.h>
+#include "variant.h"
+#include "tables.h"
+
+#define ALL_DIGITS 0x3FE   // Bits 1..9 set
+
+// Record that cell belongs to unit
+static int link_unit(sudoku_variant *v, int cell, int unit) {
+    if (v->cell_unit_count[cell] == MAX_CELL_UNITS) {
+        return 0;
+    }
+    v->cell_units[cell][v->cell_unit_count[cell]++] = (unsigned char)unit;
+    return 1;
+}
+
+// Start from the classic rules: rows, columns and 3x3 boxes
+void variant_init(sudoku_variant *v) {
+    memset(v, 0, sizeof(*v));
+    memset(v->cage_of, -1, sizeof(v->cage_of));
+
+    memcpy(v->units, unit_cells, sizeof(unit_cells));
+    v->unit_count = NUM_UNITS;
+
+    // Every cell's first three units are its row, column and region
+    for (int cell = 0; cell < NUM_CELLS; cell++) {
+        int row = cell / SIZE, col = cell % SIZE;
+        link_unit(v, cell, row);
+        link_unit(v, cell, SIZE + col);
+        link_unit(v, cell, 2 * SIZE + box_of_cell[cell]);
+    }
+}
+
+// Add an extra set of 9 cells that must contain every digit once
+int variant_add_unit(sudoku_variant *v, const unsigned char cells[SIZE]) {
+    if (v->unit_count == MAX_UNITS) {
+        return 0;
+    }
+    for (int i = 0; i < SIZE; i++) {
+        if (cells[i] >= NUM_CELLS || v->cell_unit_count[cells[i]] == MAX_CELL_UNITS) {
+            return 0;
+        }
+        for (int j = 0; j < i; j++) {
+            if (cells[j] == cells[i]) return 0;
+        }
+    }
+
+    int unit = v->unit_count++;
+    memcpy(v->units[unit], cells, SIZE);
+    for (int i = 0; i < SIZE; i++) {
+        link_unit(v, cells[i], unit);
+    }
+    return 1;
+}
+
+// X-sudoku: both main diagonals must also contain 1-9
+int variant_add_diagonals(sudoku_variant *v) {
+    unsigned char main_diag[SIZE], anti_diag[SIZE];
+    for (int i = 0; i < SIZE; i++) {
+        main_diag[i] = (unsigned char)(i * SIZE + i);
+        anti_diag[i] = (unsigned char)(i * SIZE + (SIZE - 1 - i));
+    }
+    return variant_add_unit(v, main_diag) && variant_add_unit(v, anti_diag);
+}
+
+// Jigsaw sudoku: replace the 3x3 boxes with irregular regions.
+// region_of[cell] is 0-8 and every region must have exactly 9 cells.
+int variant_set_regions(sudoku_variant *v, const unsigned char region_of[NUM_CELLS]) {
+    int filled[SIZE] = {0};
+
+    for (int cell = 0; cell < NUM_CELLS; cell++) {
+        if (region_of[cell] >= SIZE || filled[region_of[cell]] == SIZE) {
+            return 0;
+        }
+        filled[region_of[cell]]++;
+    }
+
+    memset(filled, 0, sizeof(filled));
+    for (int cell = 0; cell < NUM_CELLS; cell++) {
+        int region = region_of[cell];
+        v->units[2 * SIZE + region][filled[region]++] = (unsigned char)cell;
+        v->cell_units[cell][2] = (unsigned char)(2 * SIZE + region);
+    }
+    return 1;
+}
+
+// Killer cage: count different digits in cells that add up to sum
+int variant_add_cage(sudoku_variant *v, const unsigned char cells[], int count, int sum) {
+    if (v->cage_count == MAX_CAGES || count < 1 || count > SIZE ||
+        sum < 1 || sum > MAX_CAGE_SUM || cage_combos[count][sum] == 0) {
+        return 0; // No set of digits can fill this cage
+    }
+    for (int i = 0; i < count; i++) {
+        if (cells[i] >= NUM_CELLS || v->cage_of[cells[i]] >= 0) {
+            return 0; // Bad cell, or cell already in a cage
+        }
+        for (int j = 0; j < i; j++) {
+            if (cells[j] == cells[i]) return 0;
+        }
+    }
+
+    killer_cage *cage = &v->cages[v->cage_count];
+    memcpy(cage->cells, cells, (size_t)count);
+    cage->count = count;
+    cage->sum = sum;
+    for (int i = 0; i < count; i++) {
+        v->cage_of[cells[i]] = (signed char)v->cage_count;
+    }
+    v->cage_count++;
+    return 1;
+}
+
+// Check a (possibly partial) grid: no repeated digit in any unit or cage,
+// no cage over its sum, and every full cage exactly on its sum
+int is_variant_grid_valid(int grid[SIZE][SIZE], const sudoku_variant *v) {
+    for (int u = 0; u < v->unit_count; u++) {
+        unsigned short seen = 0;
+        for (int i = 0; i < SIZE; i++) {
+            int cell = v->units[u][i];
+            int value = grid[cell / SIZE][cell % SIZE];
+            if (value == 0) continue;
+            if (value < 1 || value > SIZE || (seen & (1u << value))) return 0;
+            seen |= (unsigned short)(1u << value);
+        }
+    }
+
+    for (int k = 0; k < v->cage_count; k++) {
+        const killer_cage *cage = &v->cages[k];
+        unsigned short seen = 0;
+        int sum = 0, filled = 0;
+        for (int i = 0; i < cage->count; i++) {
+            int value = grid[cage->cells[i] / SIZE][cage->cells[i] % SIZE];
+            if (value == 0) continue;
+            if (value < 1 || value > SIZE || (seen & (1u << value))) return 0;
+            seen |= (unsigned short)(1u << value);
+            sum += value;
+            filled++;
+        }
+        if (sum > cage->sum || (filled == cage->count && sum != cage->sum)) return 0;
+    }
+    return 1;
+}
+
+// Search state: digits used per unit and per cage
+typedef struct {
+    const sudoku_variant *v;
+    int (*grid)[SIZE];
+    unsigned short unit_used[MAX_UNITS];
+    unsigned short cage_used[MAX_CAGES];
+    int cage_sum_left[MAX_CAGES];
+    int cage_cells_left[MAX_CAGES];
+} variant_search;
+
+// Digits that can go in cell without breaking any unit or cage
+static unsigned short candidates(const variant_search *s, int cell) {
+    const sudoku_variant *v = s->v;
+    unsigned short used = 0;
+
+    for (int k = 0; k < v->cell_unit_count[cell]; k++) {
+        used |= s->unit_used[v->cell_units[cell][k]];
+    }
+    unsigned short mask = (unsigned short)(ALL_DIGITS & ~used);
+
+    int cage = v->cage_of[cell];
+    if (cage >= 0) {
+        // Only digits from a combination that can still complete the cage.
+        // With one cell left this allows exactly the missing amount.
+        int left = s->cage_sum_left[cage];
+        mask &= (left >= 0 && left <= MAX_CAGE_SUM) ? cage_combos[s->cage_cells_left[cage]][left] : 0;
+        mask &= (unsigned short)~s->cage_used[cage];
+    }
+    return mask;
+}
+
+static void place(variant_search *s, int cell, int digit) {
+    const sudoku_variant *v = s->v;
+    unsigned short bit = (unsigned short)(1u << digit);
+
+    s->grid[cell / SIZE][cell % SIZE] = digit;
+    for (int k = 0; k < v->cell_unit_count[cell]; k++) {
+        s->unit_used[v->cell_units[cell][k]] |= bit;
+    }
+    int cage = v->cage_of[cell];
+    if (cage >= 0) {
+        s->cage_used[cage] |= bit;
+        s->cage_sum_left[cage] -= digit;
+        s->cage_cells_left[cage]--;
+    }
+}
+
+static void unplace(variant_search *s, int cell, int digit) {
+    const sudoku_variant *v = s->v;
+    unsigned short mask = (unsigned short)~(1u << digit);
+
+    s->grid[cell / SIZE][cell % SIZE] = 0;
+    for (int k = 0; k < v->cell_unit_count[cell]; k++) {
+        s->unit_used[v->cell_units[cell][k]] &= mask;
+    }
+    int cage = v->cage_of[cell];
+    if (cage >= 0) {
+        s->cage_used[cage] &= mask;
+        s->cage_sum_left[cage] += digit;
+        s->cage_cells_left[cage]++;
+    }
+}
+
+// Backtracking, always branching on the empty cell with the fewest candidates
+static int search(variant_search *s) {
+    int best = -1, best_count = SIZE + 1;
+    unsigned short best_mask = 0;
+
+    for (int cell = 0; cell < NUM_CELLS; cell++) {
+        if (s->grid[cell / SIZE][cell % SIZE] != 0) continue;
+        unsigned short mask = candidates(s, cell);
+        int count = 0;
+        for (unsigned short m = mask; m; m &= (unsigned short)(m - 1)) count++;
+        if (count < best_count) {
+            best = cell;
+            best_count = count;
+            best_mask = mask;
+            if (count <= 1) break;
+        }
+    }
+
+    if (best < 0) {
+        return 1; // No empty cells left
+    }
+
+    for (int digit = 1; digit <= SIZE; digit++) {
+        if (!(best_mask & (1u << digit))) continue;
+        place(s, best, digit);
+        if (search(s)) {
+            return 1;
+        }
+        unplace(s, best, digit);
+    }
+    return 0;
+}
+
+// Solve grid in place under the rules in v. Returns 1 if a solution was found.
+int solve_variant(int grid[SIZE][SIZE], const sudoku_variant *v) {
+    variant_search s;
+
+    memset(&s, 0, sizeof(s));
+    s.v = v;
+    s.grid = grid;
+    for (int k = 0; k < v->cage_count; k++) {
+        s.cage_sum_left[k] = v->cages[k].sum;
+        s.cage_cells_left[k] = v->cages[k].count;
+    }
+
+    // Place the clues through the same checks as search decisions
+    for (int cell = 0; cell < NUM_CELLS; cell++) {
+        int digit = grid[cell / SIZE][cell % SIZE];
+        if (digit == 0) continue;
+        grid[cell / SIZE][cell % SIZE] = 0;
+        if (digit < 1 || digit > SIZE || !(candidates(&s, cell) & (1u << digit))) {
+            grid[cell / SIZE][cell % SIZE] = digit;
+            return 0; // Clue breaks a rule
+        }
+        place(&s, cell, digit);
+    }
+
+    return search(&s);
+}
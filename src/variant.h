@@ -0,0 +1,59 @@
+#ifndef VARIANT_H
+#define VARIANT_H
+
+#include "sudoku.h"
+
+// Rule set for sudoku variants: classic rows and columns, plus
+//  - regions: the 3x3 boxes, or irregular jigsaw regions
+//  - extra units: any 9 cells that must hold 1-9 (e.g. the X-sudoku diagonals)
+//  - cages: killer cages whose digits differ and add up to a given sum
+//
+// The variants have their own fewest-candidates search instead of hooks in
+// the classic solvers. Those solvers (solve_sudoku, the enumerator, the
+// batch propagator and the backjumping solver) are written around the fixed
+// geometry in tables.h: 20 peers per cell, box_of_cell and the packed digit
+// lookups. C can't specialize them for a rule set at compile time. A rules
+// pointer on their inner loops would only fold away where the compiler
+// inlines a constant classic rule set, and that can't be relied on across
+// translation units. So classic puzzles keep using those paths unchanged, and
+// the background jobs, re-solve and batch solving stay classic-only.
+// tools/bench -v compares the throughput of each rule set with classic.
+
+#define MAX_EXTRA_UNITS 4
+#define MAX_CAGES NUM_CELLS
+#define MAX_UNITS (NUM_UNITS + MAX_EXTRA_UNITS)
+#define MAX_CELL_UNITS (3 + MAX_EXTRA_UNITS)   // Row, column, region and extras
+
+typedef struct {
+    unsigned char cells[SIZE];
+    int count;
+    int sum;
+} killer_cage;
+
+typedef struct {
+    // Unit table: rows 0-8, columns 9-17, regions 18-26, then extra units
+    unsigned char units[MAX_UNITS][SIZE];
+    int unit_count;
+
+    killer_cage cages[MAX_CAGES];
+    int cage_count;
+    signed char cage_of[NUM_CELLS];            // Cage index of each cell, -1 if none
+
+    // Units each cell belongs to, so a cell's candidates are found with a
+    // handful of table lookups whatever the variant
+    unsigned char cell_units[NUM_CELLS][MAX_CELL_UNITS];
+    unsigned char cell_unit_count[NUM_CELLS];
+} sudoku_variant;
+
+// Building a rule set. Each function returns 0 if the request is invalid.
+void variant_init(sudoku_variant *v);
+int variant_add_unit(sudoku_variant *v, const unsigned char cells[SIZE]);
+int variant_add_diagonals(sudoku_variant *v);
+int variant_set_regions(sudoku_variant *v, const unsigned char region_of[NUM_CELLS]);
+int variant_add_cage(sudoku_variant *v, const unsigned char cells[], int count, int sum);
+
+// Checking and solving
+int is_variant_grid_valid(int grid[SIZE][SIZE], const sudoku_variant *v);
+int solve_variant(int grid[SIZE][SIZE], const sudoku_variant *v);
+
+#endif
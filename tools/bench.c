@@ -0,0 +1,368 @@
+// Benchmark the solvers on a file of puzzles, one per line (81 characters,
+// digits 1-9 for clues and '0' or '.' for empty cells).
+//
+// Usage: bench [-e plain|cbj] [-p] [-q] [-s] [-t trace.bin] puzzles.txt
+//   -e   solver to benchmark (default plain = solve_sudoku)
+//   -p   run singles propagation (batch_propagate) before the search
+//   -q   only print the totals, not one line per puzzle
+//   -s   print each solution under its puzzle line
+//   -t   record a search trace (needs a make TRACE=1 build; see src/trace.h).
+//        Times then include the tracer's overhead.
+//
+//   bench -v count
+//   Instead of reading a file, solve count generated puzzles under each rule
+//   set (classic, X, jigsaw, killer) and compare their throughput.
+//
+// Every puzzle is split into phases (parse, validate, propagate, search,
+// output). Each phase is timed and, on Linux, wrapped in hardware counters
+// (cycles, instructions, branch misses, L1d and LLC misses) so solver
+// changes can be compared by IPC and miss rates, not just wall-clock time.
+// Where counters aren't available the tool reports times only.
+
+#ifdef __linux__
+#define _POSIX_C_SOURCE 199309L   // clock_gettime
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../src/sudoku.h"
+#include "../src/batch.h"
+#include "../src/cbj.h"
+#include "../src/variant.h"
+#include "../src/trace.h"
+#include "perf_counters.h"
+
+#define PHASE_PARSE     0
+#define PHASE_VALIDATE  1
+#define PHASE_PROPAGATE 2
+#define PHASE_SEARCH    3
+#define PHASE_OUTPUT    4
+#define PHASE_COUNT     5
+
+static const char *phase_names[PHASE_COUNT] = {
+    "parse", "validate", "propagate", "search", "output"
+};
+
+// Time and counter totals for one phase
+typedef struct {
+    unsigned long long ns;
+    unsigned long long counters[PC_COUNT];
+} phase_totals;
+
+static perf_counters counters;
+static unsigned long long phase_start_ns;
+
+static unsigned long long now_ns(void) {
+#ifdef __linux__
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ull + (unsigned long long)ts.tv_nsec;
+#else
+    return (unsigned long long)clock() * (1000000000ull / CLOCKS_PER_SEC);
+#endif
+}
+
+// Counters are started before and stopped after the timestamps, so the
+// ioctls and the group read don't count towards the phase's time
+static void phase_begin(void) {
+    perf_start(&counters);
+    phase_start_ns = now_ns();
+}
+
+// Stop measuring and add the phase's numbers to this puzzle's and the overall totals
+static void phase_end(phase_totals *puzzle, phase_totals *overall) {
+    unsigned long long values[PC_COUNT];
+
+    unsigned long long ns = now_ns() - phase_start_ns;
+    perf_stop(&counters, values);
+
+    puzzle->ns += ns;
+    overall->ns += ns;
+    for (int i = 0; i < PC_COUNT; i++) {
+        puzzle->counters[i] += values[i];
+        overall->counters[i] += values[i];
+    }
+}
+
+static double ipc(const phase_totals *t) {
+    return t->counters[PC_CYCLES] ? (double)t->counters[PC_INSTRUCTIONS] / (double)t->counters[PC_CYCLES] : 0.0;
+}
+
+// Read one 81-cell puzzle from line. Returns 0 if the line isn't a puzzle.
+static int parse_puzzle(const char *line, int grid[SIZE][SIZE]) {
+    int cell = 0;
+    for (const char *p = line; *p && *p != '\n' && *p != '\r' && cell < NUM_CELLS; p++) {
+        if (*p >= '1' && *p <= '9') {
+            grid[cell / SIZE][cell % SIZE] = *p - '0';
+        } else if (*p == '0' || *p == '.') {
+            grid[cell / SIZE][cell % SIZE] = 0;
+        } else {
+            return 0;
+        }
+        cell++;
+    }
+    return cell == NUM_CELLS;
+}
+
+static void print_totals(const char *label, const phase_totals *t) {
+    printf("%-10s %12.3f ms", label, (double)t->ns / 1e6);
+    if (counters.available) {
+        for (int i = 0; i < PC_COUNT; i++) {
+            printf(" %14llu", t->counters[i]);
+        }
+        printf(" %6.2f", ipc(t));
+    }
+    printf("\n");
+}
+
+// Variant benchmark: rule sets and the clue counts their puzzles keep
+#define VARIANT_CLUES 28
+#define KILLER_CLUES 16
+
+// Jigsaw regions: the boxes of each band shifted one column per row
+static void staggered_regions(unsigned char region_of[NUM_CELLS]) {
+    for (int cell = 0; cell < NUM_CELLS; cell++) {
+        int row = cell / SIZE, col = cell % SIZE;
+        region_of[cell] = (unsigned char)((row / 3) * 3 + ((col + row % 3) / 3) % 3);
+    }
+}
+
+// Killer cages of two cells covering the grid (plus one single), with sums
+// taken from solution
+static void add_pair_cages(sudoku_variant *v, int solution[SIZE][SIZE]) {
+    unsigned char cells[2];
+
+    for (int row = 0; row < SIZE; row++) {
+        for (int col = 0; col + 1 < SIZE; col += 2) {
+            cells[0] = (unsigned char)(row * SIZE + col);
+            cells[1] = (unsigned char)(row * SIZE + col + 1);
+            variant_add_cage(v, cells, 2, solution[row][col] + solution[row][col + 1]);
+        }
+    }
+    for (int row = 0; row + 1 < SIZE; row += 2) {
+        cells[0] = (unsigned char)(row * SIZE + SIZE - 1);
+        cells[1] = (unsigned char)((row + 1) * SIZE + SIZE - 1);
+        variant_add_cage(v, cells, 2, solution[row][SIZE - 1] + solution[row + 1][SIZE - 1]);
+    }
+    cells[0] = (unsigned char)(NUM_CELLS - 1);
+    variant_add_cage(v, cells, 1, solution[SIZE - 1][SIZE - 1]);
+}
+
+// A random relabelling of base with all but clues cells cleared
+static void make_variant_puzzle(int base[SIZE][SIZE], int solution[SIZE][SIZE], int puzzle[SIZE][SIZE], int clues) {
+    int digits[SIZE + 1] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    int order[NUM_CELLS];
+
+    shuffle_array(digits + 1, SIZE);
+    for (int cell = 0; cell < NUM_CELLS; cell++) {
+        solution[cell / SIZE][cell % SIZE] = digits[base[cell / SIZE][cell % SIZE]];
+        puzzle[cell / SIZE][cell % SIZE] = 0;
+        order[cell] = cell;
+    }
+    shuffle_array(order, NUM_CELLS);
+    for (int i = 0; i < clues; i++) {
+        puzzle[order[i] / SIZE][order[i] % SIZE] = solution[order[i] / SIZE][order[i] % SIZE];
+    }
+}
+
+// Solve count puzzles under each rule set and print puzzles per second
+static int run_variant_bench(int count) {
+    static const char *names[] = {"classic", "classic*", "X", "jigsaw", "killer"};
+    unsigned char region_of[NUM_CELLS];
+    sudoku_variant rules[5];
+    int base[5][SIZE][SIZE];
+
+    // Base solution for each rule set, from an empty grid
+    for (int r = 0; r < 5; r++) variant_init(&rules[r]);
+    variant_add_diagonals(&rules[2]);
+    staggered_regions(region_of);
+    variant_set_regions(&rules[3], region_of);
+    for (int r = 0; r < 5; r++) {
+        memset(base[r], 0, sizeof(base[r]));
+        solve_variant(base[r], &rules[r]);
+    }
+
+    srand(1);
+    printf("%-9s %8s %8s %12s %11s %11s\n", "rules", "puzzles", "solved", "puzzles/s", "vs classic", "vs classic*");
+    double rates[5];
+    for (int r = 0; r < 5; r++) {
+        unsigned long long ns = 0;
+        int solved = 0;
+        for (int n = 0; n < count; n++) {
+            int solution[SIZE][SIZE], puzzle[SIZE][SIZE];
+            sudoku_variant killer;
+            const sudoku_variant *v = &rules[r];
+
+            make_variant_puzzle(base[r], solution, puzzle, r == 4 ? KILLER_CLUES : VARIANT_CLUES);
+            if (r == 4) {
+                variant_init(&killer);
+                add_pair_cages(&killer, solution);
+                v = &killer;
+            }
+
+            unsigned long long start = now_ns();
+            // Row 0 is solve_sudoku; the rest go through solve_variant
+            int ok = r == 0 ? solve_sudoku(puzzle) : solve_variant(puzzle, v);
+            ns += now_ns() - start;
+            solved += ok && is_variant_grid_valid(puzzle, v);
+        }
+        rates[r] = ns ? (double)count * 1e9 / (double)ns : 0.0;
+        printf("%-9s %8d %8d %12.0f", names[r], count, solved, rates[r]);
+        if (r > 0 && rates[0] > 0 && rates[1] > 0) {
+            printf(" %10.2fx %10.2fx", rates[r] / rates[0], rates[r] / rates[1]);
+        }
+        printf("\n");
+    }
+    printf("classic = solve_sudoku, classic* = solve_variant with the classic rules\n");
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    const char *path = NULL;
+    const char *trace_path = NULL;
+    int use_cbj = 0, propagate = 0, quiet = 0, show = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) {
+            use_cbj = strcmp(argv[++i], "cbj") == 0;
+        } else if (strcmp(argv[i], "-p") == 0) {
+            propagate = 1;
+        } else if (strcmp(argv[i], "-q") == 0) {
+            quiet = 1;
+        } else if (strcmp(argv[i], "-s") == 0) {
+            show = 1;
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else if (strcmp(argv[i], "-v") == 0 && i + 1 < argc) {
+            return run_variant_bench(atoi(argv[++i]));
+        } else {
+            path = argv[i];
+        }
+    }
+    if (!path) {
+        fprintf(stderr, "Usage: %s [-e plain|cbj] [-p] [-q] [-s] [-t trace.bin] puzzles.txt\n"
+                        "       %s -v count\n", argv[0], argv[0]);
+        return 1;
+    }
+
+    FILE *in = fopen(path, "r");
+    if (!in) {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return 1;
+    }
+
+    if (trace_path && !trace_open(trace_path)) {
+        fprintf(stderr, "Cannot trace to %s (tracing needs a make TRACE=1 build)\n", trace_path);
+        fclose(in);
+        return 1;
+    }
+
+    if (perf_open(&counters) == 0) {
+        fprintf(stderr, "Hardware counters unavailable, reporting wall-clock time only\n");
+    }
+
+    phase_totals overall[PHASE_COUNT];
+    memset(overall, 0, sizeof(overall));
+    int puzzles = 0, solved = 0;
+    char line[256];
+
+    if (!quiet) {
+        printf("%-6s %-8s %12s", "puzzle", "result", "total_us");
+        if (counters.available) printf(" %14s %14s %6s %14s", "cycles", "instructions", "IPC", "search_IPC");
+        printf("\n");
+    }
+
+    while (fgets(line, sizeof(line), in)) {
+        phase_totals phases[PHASE_COUNT];
+        int grid[SIZE][SIZE];
+        char output[NUM_CELLS + 2];
+        int ok = 0;
+
+        memset(phases, 0, sizeof(phases));
+
+        phase_begin();
+        int parsed = parse_puzzle(line, grid);
+        phase_end(&phases[PHASE_PARSE], &overall[PHASE_PARSE]);
+        if (!parsed) continue; // Blank line or comment
+
+        phase_begin();
+        int valid = is_grid_valid(grid);
+        phase_end(&phases[PHASE_VALIDATE], &overall[PHASE_VALIDATE]);
+
+        if (valid) {
+            int status = BATCH_STUCK;
+            if (propagate) {
+                phase_begin();
+                batch_propagate(&grid, &status, 1);
+                phase_end(&phases[PHASE_PROPAGATE], &overall[PHASE_PROPAGATE]);
+            }
+
+            phase_begin();
+            if (status == BATCH_SOLVED) {
+                ok = 1;
+            } else if (status == BATCH_STUCK) {
+                ok = use_cbj ? solve_sudoku_cbj(grid, NULL) : solve_sudoku(grid);
+            }
+            phase_end(&phases[PHASE_SEARCH], &overall[PHASE_SEARCH]);
+        }
+
+        phase_begin();
+        for (int cell = 0; cell < NUM_CELLS; cell++) {
+            output[cell] = (char)('0' + grid[cell / SIZE][cell % SIZE]);
+        }
+        output[NUM_CELLS] = '\0';
+        phase_end(&phases[PHASE_OUTPUT], &overall[PHASE_OUTPUT]);
+
+        puzzles++;
+        solved += ok;
+
+        if (!quiet) {
+            phase_totals total;
+            memset(&total, 0, sizeof(total));
+            for (int p = 0; p < PHASE_COUNT; p++) {
+                total.ns += phases[p].ns;
+                for (int i = 0; i < PC_COUNT; i++) total.counters[i] += phases[p].counters[i];
+            }
+            printf("%-6d %-8s %12.1f", puzzles, ok ? "solved" : (valid ? "no-sol" : "invalid"),
+                   (double)total.ns / 1e3);
+            if (counters.available) {
+                printf(" %14llu %14llu %6.2f %14.2f", total.counters[PC_CYCLES],
+                       total.counters[PC_INSTRUCTIONS], ipc(&total), ipc(&phases[PHASE_SEARCH]));
+            }
+            printf("\n");
+        }
+        if (show) {
+            printf("%s\n", output);
+        }
+    }
+    fclose(in);
+
+    // Aggregate report per phase
+    printf("\n%d puzzles, %d solved, engine %s%s\n", puzzles, solved,
+           use_cbj ? "cbj" : "plain", propagate ? " + propagation" : "");
+    printf("%-10s %15s", "phase", "time");
+    if (counters.available) {
+        for (int i = 0; i < PC_COUNT; i++) printf(" %14s", perf_counter_name(i));
+        printf(" %6s", "IPC");
+    }
+    printf("\n");
+
+    phase_totals all;
+    memset(&all, 0, sizeof(all));
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        print_totals(phase_names[p], &overall[p]);
+        all.ns += overall[p].ns;
+        for (int i = 0; i < PC_COUNT; i++) all.counters[i] += overall[p].counters[i];
+    }
+    print_totals("total", &all);
+    if (counters.multiplexed) {
+        printf("Counters were multiplexed in %lu measurements; those counts are scaled estimates\n",
+               counters.multiplexed);
+    }
+
+    perf_close(&counters);
+    trace_close();
+    return 0;
+}
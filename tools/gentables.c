@@ -0,0 +1,271 @@
+// Generate src/tables.c: the constant lookup tables the solvers read, and
+// the built-in example puzzle with its solution. Everything is computed and
+// checked here, at build time, so the program never builds tables or solves
+// the example at startup.
+//
+// Usage: gentables [src/tables.c]           (or: make tables)
+//        gentables -c src/tables.c        (or: make check-tables)
+// Writes to stdout without an argument. The file is written with CRLF line
+// endings like the rest of the repository. -c only compares the committed
+// file with what would be generated and fails if they differ. If any check
+// fails it exits with an error before the output file is opened, so a good
+// tables.c is never lost.
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+// Kept independent of src/ so a broken table can't hide a broken generator
+#define SIZE 9
+#define NUM_CELLS (SIZE * SIZE)
+#define NUM_UNITS (3 * SIZE)
+#define NUM_PEERS 20
+#define MAX_CAGE_SUM 45
+
+static unsigned char unit_cells[NUM_UNITS][SIZE];
+static unsigned char peer_cells[NUM_CELLS][NUM_PEERS];
+static unsigned char box_of_cell[NUM_CELLS];
+static unsigned char box_top[SIZE];
+static unsigned char box_left[SIZE];
+static unsigned short low_cell_bit[256];
+static unsigned short high_cell_bit[256];
+static unsigned short cage_combos[SIZE + 1][MAX_CAGE_SUM + 1];
+
+static const int example_puzzle[SIZE][SIZE] = {
+    {5, 3, 0, 0, 7, 0, 0, 0, 0},
+    {6, 0, 0, 1, 9, 5, 0, 0, 0},
+    {0, 9, 8, 0, 0, 0, 0, 6, 0},
+    {8, 0, 0, 0, 6, 0, 0, 0, 3},
+    {4, 0, 0, 8, 0, 3, 0, 0, 1},
+    {7, 0, 0, 0, 2, 0, 0, 0, 6},
+    {0, 6, 0, 0, 0, 0, 2, 8, 0},
+    {0, 0, 0, 4, 1, 9, 0, 0, 5},
+    {0, 0, 0, 0, 8, 0, 0, 7, 9}
+};
+static int example_solution[SIZE][SIZE];
+
+// Generated text, built in memory before anything is written
+static char output[64 * 1024];
+static size_t output_len = 0;
+static int output_crlf = 0;     // Write "\r\n" for every "\n"
+
+static int fail(const char *what) {
+    fprintf(stderr, "gentables: %s\n", what);
+    return 1;
+}
+
+static void emit(const char *fmt, ...) {
+    char line[256];
+    va_list args;
+
+    va_start(args, fmt);
+    vsnprintf(line, sizeof(line), fmt, args);
+    va_end(args);
+    for (const char *p = line; *p && output_len + 2 <= sizeof(output); p++) {
+        if (*p == '\n' && output_crlf) output[output_len++] = '\r';
+        output[output_len++] = *p;
+    }
+}
+
+// Compare the generated text with the file at path. Returns 1 if identical.
+static int matches_file(const char *path) {
+    static char existing[sizeof(output) + 1];
+    FILE *f = fopen(path, "rb");
+    if (!f) return 0;
+    size_t len = fread(existing, 1, sizeof(existing), f);
+    fclose(f);
+    return len == output_len && memcmp(existing, output, len) == 0;
+}
+
+static void build_tables(void) {
+    for (int i = 0; i < SIZE; i++) {
+        box_top[i] = (unsigned char)((i / 3) * 3);
+        box_left[i] = (unsigned char)((i % 3) * 3);
+        for (int j = 0; j < SIZE; j++) {
+            unit_cells[i][j] = (unsigned char)(i * SIZE + j);                        // Row i
+            unit_cells[SIZE + i][j] = (unsigned char)(j * SIZE + i);                 // Column i
+            unit_cells[2 * SIZE + i][j] = (unsigned char)((box_top[i] + j / 3) * SIZE
+                                                          + box_left[i] + j % 3);    // Box i
+        }
+    }
+
+    for (int cell = 0; cell < NUM_CELLS; cell++) {
+        int row = cell / SIZE, col = cell % SIZE;
+        int count = 0;
+        box_of_cell[cell] = (unsigned char)((row / 3) * 3 + col / 3);
+        for (int other = 0; other < NUM_CELLS; other++) {
+            int r = other / SIZE, c = other % SIZE;
+            if (other == cell) continue;
+            if (r == row || c == col || (r / 3 == row / 3 && c / 3 == col / 3)) {
+                if (count < NUM_PEERS) peer_cells[cell][count] = (unsigned char)other;
+                count++;
+            }
+        }
+    }
+
+    for (int byte = 0; byte < 256; byte++) {
+        low_cell_bit[byte] = (unsigned short)(1u << (byte & 0x0F));
+        high_cell_bit[byte] = (unsigned short)(1u << (byte >> 4));
+    }
+
+    for (unsigned int set = 0; set < (1u << SIZE); set++) {
+        int count = 0, sum = 0;
+        unsigned short digits = 0;
+        for (int d = 1; d <= SIZE; d++) {
+            if (set & (1u << (d - 1))) {
+                count++;
+                sum += d;
+                digits |= (unsigned short)(1u << d);
+            }
+        }
+        cage_combos[count][sum] |= digits;
+    }
+}
+
+// Every unit holds 9 different cells, every cell is in exactly one row,
+// column and box, and its peers are exactly the other cells of those units
+static int check_tables(void) {
+    for (int u = 0; u < NUM_UNITS; u++) {
+        unsigned char seen[NUM_CELLS] = {0};
+        for (int i = 0; i < SIZE; i++) {
+            if (seen[unit_cells[u][i]]++) return 0;
+        }
+    }
+    for (int cell = 0; cell < NUM_CELLS; cell++) {
+        unsigned char shared[NUM_CELLS] = {0};
+        int units = 0;
+        for (int u = 0; u < NUM_UNITS; u++) {
+            for (int i = 0; i < SIZE; i++) {
+                if (unit_cells[u][i] != cell) continue;
+                units++;
+                for (int k = 0; k < SIZE; k++) shared[unit_cells[u][k]] = 1;
+            }
+        }
+        if (units != 3 || unit_cells[2 * SIZE + box_of_cell[cell]][0] / SIZE != box_top[box_of_cell[cell]]) {
+            return 0;
+        }
+        shared[cell] = 0;
+        int count = 0;
+        for (int other = 0; other < NUM_CELLS; other++) count += shared[other];
+        if (count != NUM_PEERS) return 0;
+        for (int p = 0; p < NUM_PEERS; p++) {
+            if (!shared[peer_cells[cell][p]]) return 0;
+        }
+    }
+    return 1;
+}
+
+// Count solutions of grid up to limit, keeping the first one in first
+static int count_solutions(int grid[SIZE][SIZE], int first[SIZE][SIZE], int limit) {
+    for (int cell = 0; cell < NUM_CELLS; cell++) {
+        int row = cell / SIZE, col = cell % SIZE;
+        if (grid[row][col] != 0) continue;
+
+        int found = 0;
+        for (int num = 1; num <= SIZE && found < limit; num++) {
+            int ok = 1;
+            for (int p = 0; p < NUM_PEERS && ok; p++) {
+                ok = grid[peer_cells[cell][p] / SIZE][peer_cells[cell][p] % SIZE] != num;
+            }
+            if (!ok) continue;
+            grid[row][col] = num;
+            found += count_solutions(grid, first, limit - found);
+            grid[row][col] = 0;
+        }
+        return found;
+    }
+
+    if (first[0][0] == 0) memcpy(first, grid, sizeof(int) * NUM_CELLS);
+    return 1;
+}
+
+// The example must have exactly one solution, which agrees with every clue
+static int solve_example(void) {
+    int grid[SIZE][SIZE];
+    memcpy(grid, example_puzzle, sizeof(grid));
+
+    for (int cell = 0; cell < NUM_CELLS; cell++) {
+        int value = grid[cell / SIZE][cell % SIZE];
+        for (int p = 0; p < NUM_PEERS && value; p++) {
+            if (grid[peer_cells[cell][p] / SIZE][peer_cells[cell][p] % SIZE] == value) return 0;
+        }
+    }
+    return count_solutions(grid, example_solution, 2) == 1;
+}
+
+// Print a table of rows x cols values (rows = 0 for a one-dimensional table),
+// per_line values to a line
+static void print_table(const char *decl, const unsigned short *values, int rows, int cols,
+                        int per_line, int hex) {
+    emit("%s = {", decl);
+    for (int r = 0; r < (rows ? rows : 1); r++) {
+        const char *indent = rows ? "        " : "    ";
+        if (rows) emit("%s\n    {", r ? "," : "");
+        for (int i = 0; i < cols; i++) {
+            emit("%s%s", i ? "," : "", i % per_line ? " " : (rows && i == 0 ? "" : "\n"));
+            if (i % per_line == 0 && !(rows && i == 0)) emit("%s", indent);
+            emit(hex ? "0x%04X" : "%2d", values[r * cols + i]);
+        }
+        if (rows) emit("}");
+    }
+    emit("\n};\n\n");
+}
+
+static void print_bytes(const char *decl, const unsigned char *bytes, int rows, int cols, int per_line) {
+    unsigned short values[NUM_CELLS * NUM_PEERS];
+    for (int i = 0; i < (rows ? rows : 1) * cols; i++) values[i] = bytes[i];
+    print_table(decl, values, rows, cols, per_line, 0);
+}
+
+static void print_grid(const char *decl, const int grid[SIZE][SIZE]) {
+    emit("%s = {\n", decl);
+    for (int row = 0; row < SIZE; row++) {
+        emit("    {");
+        for (int col = 0; col < SIZE; col++) {
+            emit("%s%d", col ? ", " : "", grid[row][col]);
+        }
+        emit("}%s\n", row < SIZE - 1 ? "," : "");
+    }
+    emit("};\n");
+}
+
+int main(int argc, char *argv[]) {
+    build_tables();
+    if (!check_tables()) return fail("unit or peer table check failed");
+    if (!solve_example()) return fail("example puzzle does not have exactly one solution");
+    int check_only = argc > 2 && strcmp(argv[1], "-c") == 0;
+    const char *path = check_only ? argv[2] : (argc > 1 ? argv[1] : NULL);
+    output_crlf = path != NULL;
+
+    emit("// Generated by tools/gentables.c (make tables) - do not edit by hand.\n");
+    emit("// Every table here was built and checked by the generator, and the\n");
+    emit("// example solution was found and proven unique there.\n\n");
+    emit("#include \"tables.h\"\n\n");
+    emit("// Fails to compile if the board constants no longer match these tables\n");
+    emit("typedef char tables_match_board[(SIZE == %d && NUM_PEERS == %d && MAX_CAGE_SUM == %d) ? 1 : -1];\n\n",
+           SIZE, NUM_PEERS, MAX_CAGE_SUM);
+
+    print_bytes("const unsigned char unit_cells[NUM_UNITS][SIZE]", &unit_cells[0][0], NUM_UNITS, SIZE, SIZE);
+    print_bytes("const unsigned char peer_cells[NUM_CELLS][NUM_PEERS]", &peer_cells[0][0], NUM_CELLS, NUM_PEERS, NUM_PEERS);
+    print_bytes("const unsigned char box_of_cell[NUM_CELLS]", box_of_cell, 0, NUM_CELLS, SIZE);
+    print_bytes("const unsigned char box_top[SIZE]", box_top, 0, SIZE, SIZE);
+    print_bytes("const unsigned char box_left[SIZE]", box_left, 0, SIZE, SIZE);
+    print_table("const unsigned short low_cell_bit[256]", low_cell_bit, 0, 256, 8, 1);
+    print_table("const unsigned short high_cell_bit[256]", high_cell_bit, 0, 256, 8, 1);
+    print_table("const unsigned short cage_combos[SIZE + 1][MAX_CAGE_SUM + 1]", &cage_combos[0][0],
+                SIZE + 1, MAX_CAGE_SUM + 1, 8, 1);
+    print_grid("const int example_puzzle[SIZE][SIZE]", example_puzzle);
+    emit("\n");
+    print_grid("const int example_solution[SIZE][SIZE]", example_solution);
+    if (output_len + 2 > sizeof(output)) return fail("output buffer too small");
+
+    if (check_only) {
+        if (!matches_file(path)) return fail("src/tables.c is out of date, run make tables");
+        return 0;
+    }
+    FILE *f = path ? fopen(path, "wb") : stdout;
+    if (!f) return fail("cannot write output file");
+    fwrite(output, 1, output_len, f);
+    if (path && fclose(f) != 0) return fail("cannot write output file");
+    return 0;
+}
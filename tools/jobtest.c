@@ -0,0 +1,168 @@
+// Headless checks for the background job API (src/jobs.h). Needs no window,
+// so it runs on Linux and can be built with -fsanitize=thread:
+//
+//   make jobtest && ./tools/jobtest
+//   make jobtest CFLAGS="-std=c99 -O1 -g -fsanitize=thread"
+//
+// Prints one line per check and exits non-zero if any check failed.
+
+#include <stdio.h>
+#include <string.h>
+#include "../src/sudoku.h"
+#include "../src/jobs.h"
+#include "../src/tables.h"
+
+static int failures = 0;
+
+#define CHECK(cond) check((cond), #cond, __LINE__)
+
+static void check(int ok, const char *what, int line) {
+    if (!ok) {
+        printf("  FAILED line %d: %s\n", line, what);
+        failures++;
+    }
+}
+
+static void copy_example(int grid[SIZE][SIZE]) {
+    memcpy(grid, example_puzzle, sizeof(example_puzzle));
+}
+
+// Solve the example and compare with the solution from tools/gentables.c
+static void test_solve(void) {
+    int grid[SIZE][SIZE];
+    job_result result;
+
+    copy_example(grid);
+    sudoku_job *job = job_submit_solve(grid, NULL);
+    CHECK(job != NULL);
+    if (!job) return;
+
+    CHECK(job_wait(job, -1) == JOB_FINISHED);
+    CHECK(job_get_result(job, &result));
+    CHECK(result.state == JOB_FINISHED);
+    CHECK(result.solved && result.solutions == 1);
+    CHECK(memcmp(result.solution, example_solution, sizeof(example_solution)) == 0);
+    job_release(job);
+}
+
+// A timed wait on a search that can't finish returns before the job ends,
+// and a cancel stops it at the next slice
+static void test_timed_wait_and_cancel(void) {
+    int empty[SIZE][SIZE] = {{0}};
+    job_result result;
+    unsigned long long nodes = 0;
+
+    sudoku_job *job = job_submit_count(empty, 0, NULL);
+    CHECK(job != NULL);
+    if (!job) return;
+
+    int state = job_wait(job, 50);
+    CHECK(state == JOB_QUEUED || state == JOB_RUNNING);
+    CHECK(!job_get_result(job, &result));
+    state = job_poll(job, &nodes, NULL);
+    CHECK(state == JOB_QUEUED || state == JOB_RUNNING);
+
+    job_cancel(job);
+    CHECK(job_wait(job, -1) == JOB_CANCELLED);
+    CHECK(job_get_result(job, &result) && result.state == JOB_CANCELLED);
+    job_release(job);
+}
+
+// Counting stops at the limit
+static void test_bounded_count(void) {
+    int empty[SIZE][SIZE] = {{0}};
+    job_result result;
+
+    sudoku_job *job = job_submit_count(empty, 5, NULL);
+    CHECK(job != NULL);
+    if (!job) return;
+
+    CHECK(job_wait(job, -1) == JOB_FINISHED);
+    CHECK(job_get_result(job, &result));
+    CHECK(result.solved && result.solutions == 5);
+    job_release(job);
+}
+
+// Done callback that drops the caller's handle itself
+static int released_solved = -1;
+
+static void release_on_done(sudoku_job *job, void *user) {
+    job_result result;
+    (void)user;
+    job_get_result(job, &result);
+    released_solved = result.state == JOB_FINISHED && result.solved;
+    job_release(job);
+}
+
+// With one worker, jobs run in submit order, so once the second job has
+// ended the first job's done callback has returned
+static void test_release_in_done_callback(void) {
+    int grid[SIZE][SIZE];
+    job_callbacks cb = {NULL, release_on_done, NULL};
+
+    jobs_stop();
+    CHECK(jobs_start(1) == 1);
+
+    copy_example(grid);
+    CHECK(job_submit_solve(grid, &cb) != NULL);
+    sudoku_job *after = job_submit_solve(grid, NULL);
+    CHECK(after != NULL);
+    if (!after) return;
+
+    CHECK(job_wait(after, -1) == JOB_FINISHED);
+    CHECK(released_solved == 1);
+    job_release(after);
+}
+
+// Re-solving after a clue edit reuses the solve_state
+static void test_resolve(void) {
+    int grid[SIZE][SIZE];
+    solve_state st = {0};
+    job_result result;
+
+    copy_example(grid);
+    sudoku_job *job = job_submit_resolve(&st, grid, NULL);
+    CHECK(job != NULL);
+    if (!job) return;
+    CHECK(job_wait(job, -1) == JOB_FINISHED);
+    CHECK(job_get_result(job, &result) && result.solved);
+    job_release(job);
+
+    // Fill in one cell with its answer: the old solution still fits
+    for (int cell = 0; cell < NUM_CELLS; cell++) {
+        if (grid[cell / SIZE][cell % SIZE] == 0) {
+            grid[cell / SIZE][cell % SIZE] = example_solution[cell / SIZE][cell % SIZE];
+            break;
+        }
+    }
+    job = job_submit_resolve(&st, grid, NULL);
+    CHECK(job != NULL);
+    if (!job) return;
+    CHECK(job_wait(job, -1) == JOB_FINISHED);
+    CHECK(job_get_result(job, &result) && result.solved);
+    CHECK(memcmp(result.solution, example_solution, sizeof(example_solution)) == 0);
+    job_release(job);
+}
+
+int main(void) {
+    static const struct {
+        const char *name;
+        void (*run)(void);
+    } tests[] = {
+        {"solve", test_solve},
+        {"timed wait and cancel", test_timed_wait_and_cancel},
+        {"bounded count", test_bounded_count},
+        {"release in done callback", test_release_in_done_callback},
+        {"resolve", test_resolve},
+    };
+
+    for (size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+        int before = failures;
+        tests[i].run();
+        printf("%-26s %s\n", tests[i].name, failures == before ? "ok" : "FAILED");
+    }
+    jobs_stop();
+
+    printf("%s\n", failures ? "Some checks failed" : "All checks passed");
+    return failures ? 1 : 0;
+}
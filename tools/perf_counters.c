@@ -0,0 +1,134 @@
+#ifdef __linux__
+#define _GNU_SOURCE   // syscall()
+#endif
+
+#include <string.h>
+#include "perf_counters.h"
+
+static const char *counter_names[PC_COUNT] = {
+    "cycles", "instructions", "branch-misses", "L1d-misses", "LLC-misses"
+};
+
+const char *perf_counter_name(int counter) {
+    return counter_names[counter];
+}
+
+#ifdef __linux__
+
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+// Open one counter for this thread, user space only. group_fd -1 opens a
+// group leader, which starts disabled; members follow their leader.
+static int open_counter(unsigned int type, unsigned long long config, int group_fd) {
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = group_fd < 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+
+int perf_open(perf_counters *pc) {
+    const unsigned long long cache_read_miss =
+        (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    const unsigned int types[PC_COUNT] = {
+        PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE
+    };
+    const unsigned long long configs[PC_COUNT] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_BRANCH_MISSES,
+        PERF_COUNT_HW_CACHE_L1D | cache_read_miss, PERF_COUNT_HW_CACHE_MISSES
+    };
+
+    // The first counter that opens leads the group
+    pc->leader = -1;
+    pc->available = 0;
+    pc->multiplexed = 0;
+    for (int i = 0; i < PC_COUNT; i++) {
+        pc->fd[i] = open_counter(types[i], configs[i], pc->leader);
+        if (pc->fd[i] < 0) continue;
+        if (pc->leader < 0) pc->leader = pc->fd[i];
+        pc->available++;
+    }
+    return pc->available;
+}
+
+void perf_start(perf_counters *pc) {
+    if (pc->leader < 0) return;
+    ioctl(pc->leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(pc->leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+void perf_stop(perf_counters *pc, unsigned long long values[PC_COUNT]) {
+    // Group read: nr, time enabled, time running, then one value per
+    // counter in the order they joined the group
+    unsigned long long buf[3 + PC_COUNT];
+
+    memset(values, 0, PC_COUNT * sizeof(values[0]));
+    if (pc->leader < 0) return;
+    ioctl(pc->leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    ssize_t got = read(pc->leader, buf, sizeof(buf));
+    if (got < (ssize_t)(3 * sizeof(buf[0])) || buf[0] != (unsigned long long)pc->available ||
+        got != (ssize_t)((3 + buf[0]) * sizeof(buf[0]))) {
+        return;
+    }
+
+    unsigned long long enabled = buf[1], running = buf[2];
+    if (running == 0) {
+        pc->multiplexed++; // Group never got onto the PMU
+        return;
+    }
+    int n = 0;
+    for (int i = 0; i < PC_COUNT; i++) {
+        if (pc->fd[i] < 0) continue;
+        values[i] = buf[3 + n++];
+        if (running < enabled) {
+            values[i] = (unsigned long long)((double)values[i] * (double)enabled / (double)running);
+        }
+    }
+    if (running < enabled) pc->multiplexed++;
+}
+
+void perf_close(perf_counters *pc) {
+    for (int i = 0; i < PC_COUNT; i++) {
+        if (pc->fd[i] >= 0) close(pc->fd[i]);
+        pc->fd[i] = -1;
+    }
+    pc->leader = -1;
+    pc->available = 0;
+}
+
+#else
+
+// No perf_event_open: report no counters so callers use wall-clock time only
+
+int perf_open(perf_counters *pc) {
+    for (int i = 0; i < PC_COUNT; i++) pc->fd[i] = -1;
+    pc->leader = -1;
+    pc->available = 0;
+    pc->multiplexed = 0;
+    return 0;
+}
+
+void perf_start(perf_counters *pc) {
+    (void)pc;
+}
+
+void perf_stop(perf_counters *pc, unsigned long long values[PC_COUNT]) {
+    (void)pc;
+    memset(values, 0, PC_COUNT * sizeof(values[0]));
+}
+
+void perf_close(perf_counters *pc) {
+    (void)pc;
+}
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+// Hardware performance counters for the benchmark tool (Linux perf_event_open).
+// On other systems, or where the kernel refuses access (containers,
+// perf_event_paranoid), perf_open reports no counters and the benchmark
+// falls back to wall-clock time only.
+
+// Counter slots
+#define PC_CYCLES        0
+#define PC_INSTRUCTIONS  1
+#define PC_BRANCH_MISSES 2
+#define PC_L1D_MISSES    3
+#define PC_LLC_MISSES    4
+#define PC_COUNT         5
+
+// The counters are opened as one group, so they are always scheduled onto
+// the PMU together and started, stopped and read with one syscall each.
+typedef struct {
+    int fd[PC_COUNT];       // -1 for counters that couldn't be opened
+    int leader;             // Group leader fd, -1 if no counter opened
+    int available;          // Number of counters that opened
+    unsigned long multiplexed; // Measurements scaled because the group wasn't always running
+} perf_counters;
+
+// Open all counters for the calling thread. Returns the number available.
+int perf_open(perf_counters *pc);
+
+// Reset and start counting
+void perf_start(perf_counters *pc);
+
+// Stop counting and store the counts; unavailable counters read as 0.
+// If the kernel multiplexed the group, counts are scaled up to the time it
+// was enabled and pc->multiplexed is incremented.
+void perf_stop(perf_counters *pc, unsigned long long values[PC_COUNT]);
+
+void perf_close(perf_counters *pc);
+
+// Short name of a counter slot, for reports
+const char *perf_counter_name(int counter);
+
+#endif
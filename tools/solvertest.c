@@ -0,0 +1,379 @@
+// Headless checks for the solvers and the formats around them (no window,
+// builds on any platform):
+//
+//   make solvertest && ./tools/solvertest
+//
+// Prints one line per check and exits non-zero if any check failed.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../src/sudoku.h"
+#include "../src/cbj.h"
+#include "../src/enumerate.h"
+#include "../src/variant.h"
+#include "../src/batch.h"
+#include "../src/tables.h"
+
+#define MAX_SOLUTIONS 512
+#define RANDOM_PUZZLES 1000
+
+static int failures = 0;
+
+#define CHECK(cond) check((cond), #cond, __LINE__)
+
+static void check(int ok, const char *what, int line) {
+    if (!ok) {
+        printf("  FAILED line %d: %s\n", line, what);
+        failures++;
+    }
+}
+
+// The example puzzle with its last two rows cleared: 240 solutions
+static void multi_solution_puzzle(int grid[SIZE][SIZE]) {
+    memcpy(grid, example_puzzle, sizeof(example_puzzle));
+    memset(grid[SIZE - 2], 0, 2 * sizeof(grid[0]));
+}
+
+static int solutions[MAX_SOLUTIONS][SIZE][SIZE];
+static int solution_count;
+
+// Every solution of puzzle, in order, without pausing
+static void enumerate_all(int puzzle[SIZE][SIZE]) {
+    sudoku_enum e;
+
+    solution_count = 0;
+    enum_init(&e, puzzle);
+    while (solution_count < MAX_SOLUTIONS && enum_next(&e, solutions[solution_count])) {
+        solution_count++;
+    }
+}
+
+// Pause every few nodes, continue from a copy of the paused state each time,
+// and expect exactly the uninterrupted sequence
+static void test_enum_checkpoint(void) {
+    int puzzle[SIZE][SIZE], solution[SIZE][SIZE];
+    sudoku_enum e, checkpoint;
+    int found = 0, pauses = 0, mismatches = 0;
+
+    multi_solution_puzzle(puzzle);
+    enumerate_all(puzzle);
+    CHECK(solution_count > 1 && solution_count < MAX_SOLUTIONS);
+
+    enum_init(&e, puzzle);
+    for (;;) {
+        int status = enum_next_limited(&e, solution, 7);
+        if (status == ENUM_DONE) break;
+        if (status == ENUM_PAUSED) {
+            memcpy(&checkpoint, &e, sizeof(e));
+            memset(&e, 0xA5, sizeof(e)); // The original must not be needed again
+            memcpy(&e, &checkpoint, sizeof(e));
+            pauses++;
+            continue;
+        }
+        if (found >= solution_count || memcmp(solution, solutions[found], sizeof(solution)) != 0) {
+            mismatches++;
+        }
+        found++;
+    }
+    CHECK(pauses > 0);
+    CHECK(found == solution_count);
+    CHECK(mismatches == 0);
+    CHECK(e.solutions == (unsigned long long)solution_count);
+}
+
+// enumerate_to_file writes the same sequence in packed form
+static void test_enum_packed_file(void) {
+    int puzzle[SIZE][SIZE], grid[SIZE][SIZE];
+    unsigned char packed[SUDOKU_PACKED_SIZE];
+    int read = 0, mismatches = 0;
+
+    multi_solution_puzzle(puzzle);
+    enumerate_all(puzzle);
+
+    FILE *f = tmpfile();
+    CHECK(f != NULL);
+    if (!f) return;
+    CHECK(enumerate_to_file(puzzle, f, 0) == (unsigned long long)solution_count);
+    rewind(f);
+    while (fread(packed, sizeof(packed), 1, f) == 1) {
+        unpack_grid(packed, grid);
+        if (read >= solution_count || memcmp(grid, solutions[read], sizeof(grid)) != 0) {
+            mismatches++;
+        }
+        read++;
+    }
+    fclose(f);
+    CHECK(read == solution_count);
+    CHECK(mismatches == 0);
+
+    // The budget stops the stream early
+    f = tmpfile();
+    if (!f) return;
+    CHECK(enumerate_to_file(puzzle, f, 3) == 3);
+    CHECK(ftell(f) == 3 * SUDOKU_PACKED_SIZE);
+    fclose(f);
+}
+
+// grid is complete, follows the rules and keeps every clue of puzzle
+static int solves(int grid[SIZE][SIZE], int puzzle[SIZE][SIZE]) {
+    if (!is_grid_complete(grid) || !is_grid_valid(grid)) return 0;
+    for (int cell = 0; cell < NUM_CELLS; cell++) {
+        int clue = puzzle[cell / SIZE][cell % SIZE];
+        if (clue && grid[cell / SIZE][cell % SIZE] != clue) return 0;
+    }
+    return 1;
+}
+
+// Random puzzles, some made unsolvable by a changed or added clue: the
+// backjumping solver must agree with the variant solver (classic rules) on
+// whether a solution exists, and any grid it returns must be a solution
+static void test_cbj_random(void) {
+    sudoku_variant classic;
+    int unsolvable = 0, disagree = 0, bad = 0;
+
+    variant_init(&classic);
+    srand(12345);
+    for (int n = 0; n < RANDOM_PUZZLES; n++) {
+        int solution[SIZE][SIZE], puzzle[SIZE][SIZE], a[SIZE][SIZE], b[SIZE][SIZE];
+
+        generate_complete_sudoku(solution);
+        create_puzzle_from_solution(solution, puzzle, n % 3);
+        for (int edits = n % 4; edits > 0; edits--) {
+            int cell = rand() % NUM_CELLS;
+            puzzle[cell / SIZE][cell % SIZE] = 1 + rand() % SIZE;
+        }
+
+        memcpy(a, puzzle, sizeof(a));
+        memcpy(b, puzzle, sizeof(b));
+        int cbj_solved = solve_sudoku_cbj(a, NULL);
+        int reference = solve_variant(b, &classic);
+        if (cbj_solved != reference) disagree++;
+        if (cbj_solved && !solves(a, puzzle)) bad++;
+        if (!reference) unsolvable++;
+    }
+    CHECK(disagree == 0);
+    CHECK(bad == 0);
+    CHECK(unsolvable > 0 && unsolvable < RANDOM_PUZZLES);
+}
+
+// stats is written on every return path, including bad clues
+static void test_cbj_stats(void) {
+    int grid[SIZE][SIZE];
+    cbj_stats stats;
+
+    memcpy(grid, example_puzzle, sizeof(example_puzzle));
+    memset(&stats, 0x55, sizeof(stats));
+    CHECK(solve_sudoku_cbj(grid, &stats));
+    CHECK(memcmp(grid, example_solution, sizeof(example_solution)) == 0);
+    CHECK(stats.nodes > 0 && stats.nodes < 100000);
+
+    // Two 5s in the first row
+    memcpy(grid, example_puzzle, sizeof(example_puzzle));
+    grid[0][2] = 5;
+    memset(&stats, 0x55, sizeof(stats));
+    CHECK(!solve_sudoku_cbj(grid, &stats));
+    CHECK(stats.nodes == 0 && stats.backjumps == 0);
+    CHECK(stats.nogoods_learned == 0 && stats.nogood_hits == 0);
+
+    // Out-of-range clue
+    memcpy(grid, example_puzzle, sizeof(example_puzzle));
+    grid[0][2] = 12;
+    memset(&stats, 0x55, sizeof(stats));
+    CHECK(!solve_sudoku_cbj(grid, &stats));
+    CHECK(stats.nodes == 0);
+}
+
+// Clear all but every third cell of solution, keeping 27 clues
+static void thin_out(int solution[SIZE][SIZE], int puzzle[SIZE][SIZE]) {
+    for (int cell = 0; cell < NUM_CELLS; cell++) {
+        puzzle[cell / SIZE][cell % SIZE] = cell % 3 == 0 ? solution[cell / SIZE][cell % SIZE] : 0;
+    }
+}
+
+// Solve a puzzle made from the rules' own solution of the empty grid and
+// check the answer keeps the clues and follows the rules
+static int variant_round_trip(const sudoku_variant *v, int solution[SIZE][SIZE]) {
+    int puzzle[SIZE][SIZE], grid[SIZE][SIZE];
+
+    memset(solution, 0, sizeof(int) * NUM_CELLS);
+    if (!solve_variant(solution, v) || !is_variant_grid_valid(solution, v)) return 0;
+    thin_out(solution, puzzle);
+    memcpy(grid, puzzle, sizeof(grid));
+    if (!solve_variant(grid, v) || !is_variant_grid_valid(grid, v)) return 0;
+    for (int cell = 0; cell < NUM_CELLS; cell++) {
+        int clue = puzzle[cell / SIZE][cell % SIZE];
+        if (clue && grid[cell / SIZE][cell % SIZE] != clue) return 0;
+    }
+    return is_grid_complete(grid);
+}
+
+static void test_variant_x(void) {
+    sudoku_variant v;
+    int solution[SIZE][SIZE];
+    unsigned short main_diag = 0, anti_diag = 0;
+
+    variant_init(&v);
+    CHECK(variant_add_diagonals(&v));
+    CHECK(variant_round_trip(&v, solution));
+    for (int i = 0; i < SIZE; i++) {
+        main_diag |= (unsigned short)(1u << solution[i][i]);
+        anti_diag |= (unsigned short)(1u << solution[i][SIZE - 1 - i]);
+    }
+    CHECK(main_diag == 0x3FE && anti_diag == 0x3FE);
+
+    // Two 1s on the main diagonal, in different rows, columns and boxes
+    int grid[SIZE][SIZE] = {{0}};
+    grid[0][0] = 1;
+    grid[4][4] = 1;
+    CHECK(!is_variant_grid_valid(grid, &v));
+    CHECK(!solve_variant(grid, &v));
+
+    // A unit that lists a cell twice is rejected
+    unsigned char cells[SIZE] = {0, 1, 2, 3, 4, 5, 6, 7, 7};
+    CHECK(!variant_add_unit(&v, cells));
+}
+
+static void test_variant_jigsaw(void) {
+    sudoku_variant v;
+    unsigned char region_of[NUM_CELLS];
+    int solution[SIZE][SIZE];
+
+    // The boxes of each band shifted one column per row
+    for (int cell = 0; cell < NUM_CELLS; cell++) {
+        int row = cell / SIZE, col = cell % SIZE;
+        region_of[cell] = (unsigned char)((row / 3) * 3 + ((col + row % 3) / 3) % 3);
+    }
+    variant_init(&v);
+    CHECK(variant_set_regions(&v, region_of));
+    CHECK(variant_round_trip(&v, solution));
+
+    int region_ok = 1;
+    for (int region = 0; region < SIZE; region++) {
+        unsigned short seen = 0;
+        for (int cell = 0; cell < NUM_CELLS; cell++) {
+            if (region_of[cell] == region) seen |= (unsigned short)(1u << solution[cell / SIZE][cell % SIZE]);
+        }
+        region_ok &= seen == 0x3FE;
+    }
+    CHECK(region_ok);
+
+    // A region with ten cells is rejected
+    region_of[1] = region_of[0] == 0 ? 1 : 0;
+    region_of[2] = region_of[1];
+    CHECK(!variant_set_regions(&v, region_of));
+}
+
+static void test_variant_killer(void) {
+    sudoku_variant v;
+    int solution[SIZE][SIZE], puzzle[SIZE][SIZE], grid[SIZE][SIZE];
+    unsigned char cells[2];
+
+    // Horizontal pair cages over the classic example's solution
+    memcpy(solution, example_solution, sizeof(solution));
+    variant_init(&v);
+    for (int row = 0; row < SIZE; row++) {
+        for (int col = 0; col + 1 < SIZE; col += 2) {
+            cells[0] = (unsigned char)(row * SIZE + col);
+            cells[1] = (unsigned char)(row * SIZE + col + 1);
+            CHECK(variant_add_cage(&v, cells, 2, solution[row][col] + solution[row][col + 1]));
+        }
+    }
+    CHECK(is_variant_grid_valid(solution, &v));
+    thin_out(solution, puzzle);
+    memcpy(grid, puzzle, sizeof(grid));
+    CHECK(solve_variant(grid, &v) && is_variant_grid_valid(grid, &v) && solves(grid, puzzle));
+
+    // A full cage with the wrong sum is rejected, a partial one is not
+    int sum = solution[0][0] + solution[0][1];
+    memset(grid, 0, sizeof(grid));
+    grid[0][0] = 1;
+    CHECK(is_variant_grid_valid(grid, &v));
+    grid[0][1] = sum == 3 ? 3 : 2;
+    CHECK(!is_variant_grid_valid(grid, &v));
+
+    // No two different digits add up to 18, and cells can't repeat
+    cells[0] = 0;
+    cells[1] = 1;
+    variant_init(&v);
+    CHECK(!variant_add_cage(&v, cells, 2, 18));
+    cells[1] = 0;
+    CHECK(!variant_add_cage(&v, cells, 2, 3));
+}
+
+// Completed-grid checks straight from packed bytes. Units are numbered rows
+// 0-8, columns 9-17, boxes 18-26.
+static void test_packed_verifier(void) {
+    enum { GRIDS = 10 };
+    static unsigned char packed[GRIDS][SUDOKU_PACKED_SIZE];
+    unsigned char pass_bits[(GRIDS + 7) / 8];
+    int first_bad_unit[GRIDS];
+    int grid[SIZE][SIZE];
+
+    memcpy(grid, example_solution, sizeof(grid));
+    for (int i = 0; i < GRIDS; i++) {
+        pack_grid(grid, packed[i]);
+    }
+
+    // 1: an empty cell in the middle of row 4
+    memcpy(grid, example_solution, sizeof(grid));
+    grid[4][4] = 0;
+    pack_grid(grid, packed[1]);
+
+    // 2, 3: nibble values 10-15 (cell 1 is the high nibble of byte 0, cell 80
+    // the low nibble of byte 40)
+    packed[2][0] = (unsigned char)((packed[2][0] & 0x0F) | 0xC0);
+    packed[3][40] = (unsigned char)((packed[3][40] & 0xF0) | 0x0A);
+
+    // 4: a repeated digit in row 8 (and column 8)
+    memcpy(grid, example_solution, sizeof(grid));
+    grid[8][8] = grid[8][7];
+    pack_grid(grid, packed[4]);
+
+    // 5: two cells swapped within row 0, so the row holds 1-9 but columns 0
+    // and 1 don't
+    memcpy(grid, example_solution, sizeof(grid));
+    grid[0][0] = example_solution[0][1];
+    grid[0][1] = example_solution[0][0];
+    pack_grid(grid, packed[5]);
+
+    // 9: the unused high nibble of the last byte is ignored
+    packed[9][40] |= 0xF0;
+
+    CHECK(verify_packed_grids(packed[0], GRIDS, pass_bits, first_bad_unit) == GRIDS - 5);
+    CHECK(pass_bits[0] == 0xC1 && pass_bits[1] == 0x03);
+    CHECK(first_bad_unit[0] == -1 && first_bad_unit[9] == -1);
+    CHECK(first_bad_unit[1] == 4);
+    CHECK(first_bad_unit[2] == 0);
+    CHECK(first_bad_unit[3] == 8);
+    CHECK(first_bad_unit[4] == 8);
+    CHECK(first_bad_unit[5] == SIZE);
+
+    // first_bad_unit is optional
+    CHECK(verify_packed_grids(packed[0], GRIDS, pass_bits, NULL) == GRIDS - 5);
+}
+
+int main(void) {
+    static const struct {
+        const char *name;
+        void (*run)(void);
+    } tests[] = {
+        {"enumerator checkpoint", test_enum_checkpoint},
+        {"enumerator packed file", test_enum_packed_file},
+        {"cbj vs variant solver", test_cbj_random},
+        {"cbj stats", test_cbj_stats},
+        {"X-sudoku", test_variant_x},
+        {"jigsaw", test_variant_jigsaw},
+        {"killer", test_variant_killer},
+        {"packed verifier", test_packed_verifier},
+    };
+
+    for (size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+        int before = failures;
+        tests[i].run();
+        printf("%-26s %s\n", tests[i].name, failures == before ? "ok" : "FAILED");
+    }
+
+    printf("%s\n", failures ? "Some checks failed" : "All checks passed");
+    return failures ? 1 : 0;
+}
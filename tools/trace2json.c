@@ -0,0 +1,164 @@
+// Convert a binary search trace (see src/trace.h) into a viewable format.
+//
+// Usage: trace2json [-f] [-e] trace.bin > out
+//   default  Chrome trace JSON (open in chrome://tracing or Perfetto).
+//            Every assignment becomes a slice nested under the assignments
+//            above it, so the search tree reads like a call stack.
+//   -f       Folded stacks for flamegraph.pl: one line per event with the
+//            path of assignments that led to it.
+//   -e       Also emit eliminations (instant events in JSON mode).
+
+#include <stdio.h>
+#include <string.h>
+#include "../src/sudoku.h"
+#include "../src/trace.h"
+
+#define MAX_DEPTH 256
+
+// Assignment open at each depth of one thread's search
+typedef struct {
+    int open[MAX_DEPTH];
+    int cell[MAX_DEPTH];
+    int value[MAX_DEPTH];
+} search_stack;
+
+static int folded = 0;
+static int with_eliminations = 0;
+static int first_json_event = 1;
+
+static void json_event(const char *phase, const char *name, unsigned int tid, unsigned int ts) {
+    printf("%s\n{\"name\":\"%s\",\"ph\":\"%s\",\"pid\":1,\"tid\":%u,\"ts\":%u%s}",
+           first_json_event ? "" : ",", name, phase, tid, ts,
+           phase[0] == 'i' ? ",\"s\":\"t\"" : "");
+    first_json_event = 0;
+}
+
+static void cell_name(char *buf, int cell, int value) {
+    sprintf(buf, "r%dc%d=%d", cell / SIZE + 1, cell % SIZE + 1, value);
+}
+
+// Close every open assignment at depth >= depth
+static void unwind(search_stack *st, int depth, unsigned int tid, unsigned int ts) {
+    for (int d = MAX_DEPTH - 1; d >= depth; d--) {
+        if (!st->open[d]) continue;
+        if (!folded) {
+            char name[32];
+            cell_name(name, st->cell[d], st->value[d]);
+            json_event("E", name, tid, ts);
+        }
+        st->open[d] = 0;
+    }
+}
+
+// Print the current path of assignments followed by label, folded-stack style
+static void folded_line(const search_stack *st, unsigned int tid, const char *label) {
+    printf("thread%u", tid);
+    for (int d = 0; d < MAX_DEPTH; d++) {
+        if (st->open[d]) {
+            char name[32];
+            cell_name(name, st->cell[d], st->value[d]);
+            printf(";%s", name);
+        }
+    }
+    printf(";%s 1\n", label);
+}
+
+static void handle_event(search_stack *st, const trace_event *ev, unsigned int tid) {
+    char name[32];
+    int depth = ev->depth;   // Always below MAX_DEPTH (one byte)
+
+    switch (ev->type) {
+        case TRACE_ASSIGN:
+            // A new digit at this depth replaces whatever was open at or below it
+            unwind(st, depth, tid, ev->seq);
+            st->open[depth] = 1;
+            st->cell[depth] = ev->cell;
+            st->value[depth] = ev->value;
+            if (folded) {
+                folded_line(st, tid, "assign");
+            } else {
+                cell_name(name, ev->cell, ev->value);
+                json_event("B", name, tid, ev->seq);
+            }
+            break;
+        case TRACE_BACKTRACK:
+            unwind(st, depth, tid, ev->seq);
+            if (folded) folded_line(st, tid, "backtrack");
+            break;
+        case TRACE_ELIMINATE:
+            if (!with_eliminations) break;
+            if (folded) {
+                folded_line(st, tid, "eliminate");
+            } else {
+                sprintf(name, "r%dc%d-%d", ev->cell / SIZE + 1, ev->cell % SIZE + 1, ev->value);
+                json_event("i", name, tid, ev->seq);
+            }
+            break;
+        case TRACE_DECISION:
+            if (folded) folded_line(st, tid, "decision");
+            break;
+        default:
+            break;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const char *path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-f") == 0) folded = 1;
+        else if (strcmp(argv[i], "-e") == 0) with_eliminations = 1;
+        else path = argv[i];
+    }
+    if (!path) {
+        fprintf(stderr, "Usage: %s [-f] [-e] trace.bin\n", argv[0]);
+        return 1;
+    }
+
+    FILE *in = fopen(path, "rb");
+    if (!in) {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return 1;
+    }
+
+    trace_file_header header;
+    if (fread(&header, sizeof(header), 1, in) != 1 ||
+        memcmp(header.magic, TRACE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != TRACE_VERSION || header.event_size != sizeof(trace_event)) {
+        fprintf(stderr, "%s is not a sudoku trace file\n", path);
+        fclose(in);
+        return 1;
+    }
+
+    // Blocks of one thread appear in order, but threads may interleave,
+    // so keep a search stack per thread id
+    static search_stack stacks[64];
+    static trace_event events[TRACE_RING_SIZE];
+    unsigned int last_ts[64] = {0};
+    unsigned int last_tid[64] = {0};
+    trace_block_header block;
+
+    if (!folded) printf("{\"traceEvents\":[");
+
+    while (fread(&block, sizeof(block), 1, in) == 1) {
+        if (block.count > TRACE_RING_SIZE ||
+            fread(events, sizeof(trace_event), block.count, in) != block.count) {
+            fprintf(stderr, "Truncated trace file\n");
+            break;
+        }
+        unsigned int slot = block.thread_id % 64;
+        for (unsigned int i = 0; i < block.count; i++) {
+            handle_event(&stacks[slot], &events[i], block.thread_id);
+            last_ts[slot] = events[i].seq;
+            last_tid[slot] = block.thread_id;
+        }
+    }
+
+    // Close anything still open at the end of each thread's trace
+    for (unsigned int slot = 0; slot < 64; slot++) {
+        unwind(&stacks[slot], 0, last_tid[slot], last_ts[slot] + 1);
+    }
+
+    if (!folded) printf("\n]}\n");
+    fclose(in);
+    return 0;
+}